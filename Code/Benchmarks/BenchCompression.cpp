@@ -0,0 +1,112 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+// Throughput of the LZ4 codec and of compressed archive reads.
+//
+// Usage: xen_bench_compression [size in MB]
+
+#include "Archive.hpp"
+#include "Compression.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+using namespace x;
+using namespace x::Filesystem;
+using Clock = std::chrono::steady_clock;
+
+// Word soup with some repetition and some noise, compresses about 2-3x like typical text assets
+static std::vector<u8> MakeData(const size_t size) {
+    static constexpr const char* kWords[] = {"vertex", "shader", "texture", "uniform ", "layout",
+                                             "float ",  "vec4 ",  "binding", "\n",      "{ }",
+                                             "0.25",    "mesh",   "normal",  "(",       ")"};
+    std::mt19937 rng(1234);
+    std::vector<u8> data;
+    data.reserve(size + 16);
+    while (data.size() < size) {
+        if (rng() % 8 == 0) {
+            data.push_back(CAST<u8>(rng()));
+            continue;
+        }
+        const char* word = kWords[rng() % std::size(kWords)];
+        data.insert(data.end(), word, word + std::strlen(word));
+    }
+    data.resize(size);
+    return data;
+}
+
+template<typename Func>
+static f64 Seconds(const i32 iterations, Func&& func) {
+    const auto start = Clock::now();
+    for (i32 i = 0; i < iterations; i++) {
+        func();
+    }
+    return std::chrono::duration<f64>(Clock::now() - start).count();
+}
+
+static void Report(const char* name, const size_t bytes, const i32 iterations, const f64 seconds) {
+    const f64 mbps = CAST<f64>(bytes) * iterations / seconds / (1024.0 * 1024.0);
+    printf("%-36s %10.1f MB/s\n", name, mbps);
+}
+
+int main(int argc, char* argv[]) {
+    const size_t size      = (argc > 1 ? std::strtoull(argv[1], None, 10) : 64) * 1024 * 1024;
+    constexpr i32 kPasses  = 5;
+    const std::vector data = MakeData(size);
+    const str archivePath  = "xen_bench_compression.xpak";
+
+    std::vector<u8> compressed(Lz4::CompressBound(size));
+    size_t compressedSize = 0;
+    Report("Lz4::Compress", size, kPasses, Seconds(kPasses, [&] {
+               compressedSize = Lz4::Compress(data, compressed);
+           }));
+    printf("%-36s %10.2f : 1\n", "Ratio", CAST<f64>(size) / CAST<f64>(compressedSize));
+
+    std::vector<u8> decompressed(size);
+    const auto stored = std::span(compressed).first(compressedSize);
+    Report("Lz4::Decompress", size, kPasses, Seconds(kPasses, [&] {
+               if (!Lz4::Decompress(stored, decompressed)) { std::abort(); }
+           }));
+    if (decompressed != data) {
+        printf("Error: round trip mismatch\n");
+        return 1;
+    }
+
+    ArchiveBuilder builder;
+    builder.AddBytes("data", data, true);
+    if (!builder.Write(archivePath)) {
+        printf("Error: failed to write '%s'\n", archivePath.c_str());
+        return 1;
+    }
+
+    const Archive archive(archivePath);
+    const ArchiveEntry* entry = archive.FindEntry("data");
+    if (!entry || !entry->IsCompressed()) {
+        printf("Error: archive entry missing or stored uncompressed\n");
+        return 1;
+    }
+
+    // One chunk at a time decodes on the calling thread only, the whole file fans out over the
+    // IoPool, so the difference between these two is the parallel decode speedup
+    std::vector<u8> block(kArchiveDefaultChunkSize);
+    Report("Archive::ReadBlock (per chunk)", size, kPasses, Seconds(kPasses, [&] {
+               for (u64 offset = 0; offset < size; offset += block.size()) {
+                   const auto count = std::min<u64>(block.size(), size - offset);
+                   archive.ReadBlock(*entry, std::span(block).first(count), offset);
+               }
+           }));
+    Report("Archive::ReadBlock (whole file)", size, kPasses, Seconds(kPasses, [&] {
+               archive.ReadBlock(*entry, decompressed, 0);
+           }));
+    if (decompressed != data) {
+        printf("Error: archive round trip mismatch\n");
+        return 1;
+    }
+
+    std::remove(archivePath.c_str());
+    return 0;
+}
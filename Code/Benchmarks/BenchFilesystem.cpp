@@ -0,0 +1,292 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+// Read throughput and latency percentiles of the FileReader and AsyncFileReader entry points on
+// synthetic text files from 4 KB up to the max size, with a cold and a warm page cache. Results
+// are printed as a table and written as JSON for perf tracking.
+//
+// Cold runs drop the file's pages with POSIX_FADV_DONTNEED before every iteration, so they're
+// only available on Linux.
+//
+// Usage: xen_bench_filesystem [directory] [max file size in MB] [json output path]
+
+#include "Filesystem.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <numeric>
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+using namespace x;
+using namespace x::Filesystem;
+using Clock = std::chrono::steady_clock;
+
+static constexpr size_t kKB            = 1024;
+static constexpr size_t kMB            = 1024 * kKB;
+static constexpr size_t kBlockSize     = 1 * kMB;
+static constexpr size_t kAsyncInFlight = 8;
+static constexpr size_t kLineLength    = 64;  // Including the newline
+static constexpr size_t kMaxLinesSize  = 256 * kMB;  // ReadAllLines needs ~2x the file in RAM
+static constexpr size_t kRunBudget     = 512 * kMB;  // Bytes read per op, size and cache state
+
+struct Op {
+    const char* name;
+    std::function<size_t(const str& path, size_t size)> run;  // Returns the bytes it read
+    size_t maxSize = SIZE_MAX;
+};
+
+struct Stats {
+    size_t iterations;
+    f64 mbps;
+    f64 meanUs;
+    f64 p50Us;
+    f64 p90Us;
+    f64 p99Us;
+    f64 maxUs;
+};
+
+static bool DropPageCache(const str& path) {
+#ifdef __linux__
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) { return false; }
+    const bool dropped = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(fd);
+    return dropped;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+// Fixed-length lines of printable text, so every reader sees the same bytes and ReadAllLines
+// has something realistic to split
+static std::vector<u8> MakeChunk(const size_t size) {
+    std::vector<u8> chunk(size);
+    for (size_t i = 0; i < size; i++) {
+        const bool lineEnd = i % kLineLength == kLineLength - 1;
+        chunk[i]           = lineEnd ? '\n' : CAST<u8>('a' + (i * 7 + i / 13) % 26);
+    }
+    return chunk;
+}
+
+// Writes the file as a gather of one repeated chunk, and syncs it, so the dirty pages can't
+// survive a cache drop
+static bool Generate(const str& path, const size_t size, std::span<const u8> chunk) {
+    if (FileReader::QueryFileSize(path) == size) { return true; }
+
+    std::vector<std::span<const u8>> parts(size / chunk.size(), chunk);
+    if (size % chunk.size() != 0) { parts.push_back(chunk.first(size % chunk.size())); }
+    return FileWriter::WriteAllBytes(path, parts, WriteMode::Atomic);
+}
+
+static f64 Percentile(const std::vector<f64>& sorted, const f64 percentile) {
+    const size_t rank = CAST<size_t>(percentile / 100.0 * CAST<f64>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+static std::optional<Stats> Measure(const Op& op, const str& path, const size_t size, bool cold) {
+    const size_t iterations = std::clamp<size_t>(kRunBudget / size, 3, cold ? 20 : 200);
+
+    // Warm runs start from a populated cache, cold ones drop it before every iteration
+    if (!cold && op.run(path, size) != size) { return Empty; }
+
+    std::vector<f64> latencies;
+    latencies.reserve(iterations);
+    for (size_t i = 0; i < iterations; i++) {
+        if (cold && !DropPageCache(path)) { return Empty; }
+        const auto start  = Clock::now();
+        const size_t read = op.run(path, size);
+        latencies.push_back(std::chrono::duration<f64, std::micro>(Clock::now() - start).count());
+        if (read != size) { return Empty; }
+    }
+
+    std::ranges::sort(latencies);
+    const f64 totalUs = std::accumulate(latencies.begin(), latencies.end(), 0.0);
+    Stats stats {};
+    stats.iterations = iterations;
+    stats.mbps       = CAST<f64>(size * iterations) / CAST<f64>(kMB) / (totalUs / 1e6);
+    stats.meanUs     = totalUs / CAST<f64>(iterations);
+    stats.p50Us      = Percentile(latencies, 50);
+    stats.p90Us      = Percentile(latencies, 90);
+    stats.p99Us      = Percentile(latencies, 99);
+    stats.maxUs      = latencies.back();
+    return stats;
+}
+
+static str FormatSize(const size_t size) {
+    if (size >= kMB) { return std::to_string(size / kMB) + " MB"; }
+    return std::to_string(size / kKB) + " KB";
+}
+
+int main(int argc, char* argv[]) {
+    const str dir           = argc > 1 ? argv[1] : "xen_bench_filesystem";
+    const size_t maxSize    = (argc > 2 ? std::strtoull(argv[2], None, 10) : 1024) * kMB;
+    const str jsonPath      = argc > 3 ? argv[3] : "xen_bench_filesystem.json";
+    const size_t sizes[]    = {4 * kKB, 64 * kKB, 1 * kMB, 16 * kMB, 256 * kMB, 1024 * kMB};
+    const std::vector chunk = MakeChunk(4 * kMB);
+
+    if (!Path(dir).CreateAll()) {
+        printf("Error: failed to create '%s'\n", dir.c_str());
+        return 1;
+    }
+
+    std::vector<u8> reused;
+    std::vector<u8> block(kBlockSize);
+    std::vector<u8> asyncBlocks(kAsyncInFlight * kBlockSize);
+    const Op ops[] = {
+      {"ReadAllBytes",
+       [](const str& path, size_t) { return FileReader::ReadAllBytes(path).size(); }},
+      {"ReadAllBytes (reused buffer)",
+       [&](const str& path, size_t) {
+           return FileReader::ReadAllBytes(path, reused).ValueOr(0);
+       }},
+      {"ReadAllText", [](const str& path, size_t) { return FileReader::ReadAllText(path).size(); }},
+      {"MapAllText (touch every page)",
+       [](const str& path, size_t) {
+           const auto mapped = FileReader::MapAllText(path);
+           if (!mapped) { return size_t {0}; }
+           const std::string_view text = mapped->Text();
+           volatile char sink          = 0;
+           for (size_t i = 0; i < text.size(); i += 4096) {
+               sink = sink + text[i];
+           }
+           return text.size();
+       }},
+      {"ReadAllLines",
+       [](const str& path, size_t) {
+           size_t total = 0;
+           for (const auto& line : FileReader::ReadAllLines(path)) {
+               total += line.size() + 1;
+           }
+           return total;
+       },
+       kMaxLinesSize},
+      {"ReadBlock (1 MB blocks)",
+       [&](const str& path, const size_t size) {
+           size_t total = 0;
+           while (total < size) {
+               const auto read = FileReader::ReadBlock(path, std::span(block), total);
+               if (!read || *read == 0) { break; }
+               total += *read;
+           }
+           return total;
+       }},
+      {"MappedFile (touch every page)",
+       [](const str& path, size_t) {
+           const MappedFile file(path, MappedFile::AccessHint::Sequential);
+           volatile u8 sink = 0;
+           for (size_t i = 0; i < file.Size(); i += 4096) {
+               sink = sink + file.Data()[i];
+           }
+           return file.Size();
+       }},
+      {"AsyncFileReader::ReadAllBytes",
+       [](const str& path, size_t) {
+           return AsyncFileReader::ReadAllBytes(path, IoPriority::Streaming).get().size();
+       }},
+      {"AsyncFileReader::ReadBlock (8 in flight)",
+       [&](const str& path, const size_t size) {
+           std::vector<std::future<FsResult<size_t>>> inFlight;
+           size_t total = 0;
+           for (u64 offset = 0; offset < size || !inFlight.empty();) {
+               while (offset < size && inFlight.size() < kAsyncInFlight) {
+                   const size_t slot = (offset / kBlockSize) % kAsyncInFlight;
+                   const auto dest = std::span(asyncBlocks).subspan(slot * kBlockSize, kBlockSize);
+                   inFlight.push_back(
+                     AsyncFileReader::ReadBlock(path, dest, offset, IoPriority::Streaming));
+                   offset += kBlockSize;
+               }
+               total += inFlight.front().get().ValueOr(0);
+               inFlight.erase(inFlight.begin());
+           }
+           return total;
+       }},
+    };
+
+    std::optional<bool> canDropCache;
+    nlohmann::json results = nlohmann::json::array();
+    printf("%-42s %8s %5s %10s %10s %10s %10s\n",
+           "Operation",
+           "Size",
+           "Cache",
+           "MB/s",
+           "p50 us",
+           "p99 us",
+           "max us");
+
+    for (const size_t size : sizes) {
+        if (size > maxSize) { break; }
+        const str path = dir + "/bench_" + std::to_string(size / kKB) + "k.txt";
+        if (!Generate(path, size, chunk)) {
+            printf("Error: failed to write '%s'\n", path.c_str());
+            return 1;
+        }
+        if (!canDropCache) {
+            canDropCache = DropPageCache(path);
+            if (!*canDropCache) { printf("Note: can't drop the page cache, skipping cold runs\n"); }
+        }
+
+        for (const Op& op : ops) {
+            if (size > op.maxSize) { continue; }
+            for (const bool cold : {true, false}) {
+                if (cold && !*canDropCache) { continue; }
+
+                const auto stats = Measure(op, path, size, cold);
+                if (!stats) {
+                    printf("Error: %s read the wrong number of bytes from '%s'\n",
+                           op.name,
+                           path.c_str());
+                    return 1;
+                }
+                printf("%-42s %8s %5s %10.1f %10.1f %10.1f %10.1f\n",
+                       op.name,
+                       FormatSize(size).c_str(),
+                       cold ? "cold" : "warm",
+                       stats->mbps,
+                       stats->p50Us,
+                       stats->p99Us,
+                       stats->maxUs);
+
+                results.push_back({
+                  {"operation", op.name},
+                  {"fileSize", size},
+                  {"cache", cold ? "cold" : "warm"},
+                  {"iterations", stats->iterations},
+                  {"throughputMBps", stats->mbps},
+                  {"bytesPerSecond", stats->mbps * CAST<f64>(kMB)},
+                  {"latencyUs",
+                   {
+                     {"mean", stats->meanUs},
+                     {"p50", stats->p50Us},
+                     {"p90", stats->p90Us},
+                     {"p99", stats->p99Us},
+                     {"max", stats->maxUs},
+                   }},
+                });
+            }
+        }
+        std::remove(path.c_str());
+    }
+
+    const nlohmann::json report = {
+      {"benchmark", "xen_bench_filesystem"},
+      {"maxFileSize", maxSize},
+      {"results", results},
+    };
+    if (!FileWriter::WriteAllText(jsonPath, report.dump(2) + "\n")) {
+        printf("Error: failed to write '%s'\n", jsonPath.c_str());
+        return 1;
+    }
+    printf("Results written to %s\n", jsonPath.c_str());
+    return 0;
+}
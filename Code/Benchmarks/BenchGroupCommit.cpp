@@ -0,0 +1,81 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+// Small file save throughput: the plain FileWriter::WriteAllBytes loop, the same loop with
+// atomic (durable) writes, and GroupCommitWriter batching the durable writes.
+//
+// Usage: xen_bench_group_commit [directory] [file count] [file size in KB]
+
+#include "Filesystem.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace x;
+using namespace x::Filesystem;
+using Clock = std::chrono::steady_clock;
+
+static void Report(const char* name, const size_t files, const size_t fileSize, const f64 seconds) {
+    const f64 mbps = CAST<f64>(files * fileSize) / seconds / (1024.0 * 1024.0);
+    printf("%-32s %10.0f files/s %10.1f MB/s\n", name, CAST<f64>(files) / seconds, mbps);
+}
+
+template<typename Func>
+static f64 Seconds(Func&& func) {
+    const auto start = Clock::now();
+    func();
+    return std::chrono::duration<f64>(Clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    const str dir         = argc > 1 ? argv[1] : "xen_bench_group_commit";
+    const size_t count    = argc > 2 ? std::strtoull(argv[2], None, 10) : 1000;
+    const size_t fileSize = (argc > 3 ? std::strtoull(argv[3], None, 10) : 4) * 1024;
+
+    if (!Path(dir).CreateAll()) {
+        printf("Error: failed to create '%s'\n", dir.c_str());
+        return 1;
+    }
+
+    std::vector<str> paths;
+    for (size_t i = 0; i < count; i++) {
+        paths.push_back(dir + "/file" + std::to_string(i) + ".bin");
+    }
+    const std::vector<u8> data(fileSize, 0xAB);
+
+    Report("WriteAllBytes (truncate)", count, fileSize, Seconds([&] {
+               for (const auto& path : paths) {
+                   FileWriter::WriteAllBytes(path, data);
+               }
+           }));
+
+    Report("WriteAllBytes (atomic)", count, fileSize, Seconds([&] {
+               for (const auto& path : paths) {
+                   FileWriter::WriteAllBytes(path, data, WriteMode::Atomic);
+               }
+           }));
+
+    bool ok = true;
+    Report("GroupCommitWriter", count, fileSize, Seconds([&] {
+               GroupCommitWriter writer;
+               std::vector<std::future<bool>> results;
+               results.reserve(count);
+               for (const auto& path : paths) {
+                   results.push_back(writer.Write(path, data));
+               }
+               for (auto& result : results) {
+                   ok = result.get() && ok;
+               }
+           }));
+
+    for (const auto& path : paths) {
+        std::remove(path.c_str());
+    }
+    if (!ok) {
+        printf("Error: some group commit writes failed\n");
+        return 1;
+    }
+    return 0;
+}
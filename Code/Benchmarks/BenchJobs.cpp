@@ -0,0 +1,138 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+// JobSystem scaling from 1 thread up to every core: a ParallelFor over a math-heavy kernel, and a
+// layered task graph of small jobs where every layer runs after the previous one through
+// JobCounter dependencies. Speedup is relative to the 1-thread run, which has no workers and
+// runs everything on the calling thread.
+//
+// Usage: xen_bench_jobs [max threads] [element count]
+
+#include "JobSystem.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace x;
+using Clock = std::chrono::steady_clock;
+
+static constexpr u32 kRepetitions  = 5;
+static constexpr u32 kGraphLayers  = 64;
+static constexpr u32 kJobsPerLayer = 256;
+static constexpr u32 kJobWork      = 2000;
+
+static f32 Kernel(const u64 i) {
+    f32 value = CAST<f32>(i % 1024) * 0.01F;
+    for (u32 step = 0; step < 32; step++) {
+        value = std::sqrt(value * value + 1.0F) + std::sin(value) * 0.5F;
+    }
+    return value;
+}
+
+static u64 JobWork(const u64 seed) {
+    u64 state = seed | 1;
+    for (u32 i = 0; i < kJobWork; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+    }
+    return state;
+}
+
+// Returns the best of kRepetitions runs in seconds, or a negative value if a result was wrong
+static f64 MeasureParallelFor(JobSystem& jobs, vector<f32>& out, const vector<f32>& expected) {
+    f64 best = 1e30;
+    for (u32 rep = 0; rep < kRepetitions; rep++) {
+        std::fill(out.begin(), out.end(), 0.0F);
+        const auto start = Clock::now();
+        jobs.ParallelFor(out.size(), [&](const u64 i) { out[i] = Kernel(i); }, 256);
+        best = std::min(best, std::chrono::duration<f64>(Clock::now() - start).count());
+        if (out != expected) { return -1.0; }
+    }
+    return best;
+}
+
+static f64 MeasureGraph(JobSystem& jobs, const u64 expected) {
+    f64 best = 1e30;
+    for (u32 rep = 0; rep < kRepetitions; rep++) {
+        vector<JobCounter> layers(kGraphLayers);
+        std::atomic<u64> sum {0};
+        const auto start = Clock::now();
+        for (u32 layer = 0; layer < kGraphLayers; layer++) {
+            for (u32 job = 0; job < kJobsPerLayer; job++) {
+                auto func = [&sum, seed = CAST<u64>(layer) * kJobsPerLayer + job] {
+                    sum.fetch_add(JobWork(seed), std::memory_order_relaxed);
+                };
+                if (layer == 0) {
+                    jobs.Run(func, &layers[layer]);
+                } else {
+                    jobs.RunAfter(layers[layer - 1], func, &layers[layer]);
+                }
+            }
+        }
+        jobs.Wait(layers.back());
+        best = std::min(best, std::chrono::duration<f64>(Clock::now() - start).count());
+        // Every layer is done by now, this only makes sure no job still touches the counters
+        for (auto& layer : layers) {
+            jobs.Wait(layer);
+        }
+        if (sum.load() != expected) { return -1.0; }
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    const u32 cores      = std::max(std::thread::hardware_concurrency(), 1U);
+    const u32 maxThreads = std::max<u32>(argc > 1 ? std::strtoul(argv[1], None, 10) : cores, 1);
+    const u64 count      = argc > 2 ? std::strtoull(argv[2], None, 10) : 4'000'000;
+
+    vector<f32> expected(count);
+    for (u64 i = 0; i < count; i++) {
+        expected[i] = Kernel(i);
+    }
+    u64 expectedSum = 0;
+    for (u64 seed = 0; seed < CAST<u64>(kGraphLayers) * kJobsPerLayer; seed++) {
+        expectedSum += JobWork(seed);
+    }
+
+    vector<u32> threadCounts;
+    for (u32 threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    printf("%-8s %14s %8s %14s %8s\n",
+           "Threads",
+           "ParallelFor ms",
+           "Speedup",
+           "Task graph ms",
+           "Speedup");
+
+    vector<f32> out(count);
+    f64 baseFor   = 0;
+    f64 baseGraph = 0;
+    for (const u32 threads : threadCounts) {
+        // The calling thread counts, it runs jobs while it waits
+        JobSystem jobs({.threadCount = threads});
+        const f64 forSeconds   = MeasureParallelFor(jobs, out, expected);
+        const f64 graphSeconds = MeasureGraph(jobs, expectedSum);
+        if (forSeconds < 0 || graphSeconds < 0) {
+            printf("Error: wrong results with %u threads\n", threads);
+            return 1;
+        }
+        if (threads == 1) {
+            baseFor   = forSeconds;
+            baseGraph = graphSeconds;
+        }
+        printf("%-8u %14.2f %7.2fx %14.2f %7.2fx\n",
+               threads,
+               forSeconds * 1e3,
+               baseFor / forSeconds,
+               graphSeconds * 1e3,
+               baseGraph / graphSeconds);
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+// Cost of a log call on the calling thread: the Logger with no arguments, three numbers and a
+// string, against formatting with snprintf and writing with a flushed fprintf, which is what a
+// printf to a terminal amounts to. The logger's own formatting and output happen on its thread
+// and aren't part of the numbers; batches are flushed between timings so nothing is dropped.
+//
+// Usage: xen_bench_log [calls] [log file, defaults to /dev/null]
+
+#include "Log.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+using namespace x;
+using Clock = std::chrono::steady_clock;
+
+static constexpr u64 kBatchSize = 1000;
+
+// Returns the average nanoseconds per call of `func`, run in batches with `between` untimed
+// after each one
+static f64 Measure(const u64 calls,
+                   const std::function<void(u64)>& func,
+                   const std::function<void()>& between) {
+    Clock::duration total {};
+    for (u64 done = 0; done < calls; done += kBatchSize) {
+        const auto start = Clock::now();
+        for (u64 i = done; i < done + kBatchSize; i++) {
+            func(i);
+        }
+        total += Clock::now() - start;
+        between();
+    }
+    return CAST<f64>(std::chrono::duration_cast<std::chrono::nanoseconds>(total).count()) /
+           CAST<f64>(calls);
+}
+
+int main(int argc, char* argv[]) {
+    const u64 calls  = std::max<u64>(argc > 1 ? std::strtoull(argv[1], None, 10) : 1'000'000, 1);
+    const cstr path  = argc > 2 ? argv[2] : "/dev/null";
+    const str player = "player_01";
+
+    Logger::Configure({.level = LogLevel::Trace, .filePath = path, .console = false});
+    auto& logger        = Logger::Get();
+    const auto flushLog = [&logger] { logger.Flush(); };
+
+    std::FILE* file = std::fopen(path, "w");
+    if (!file) {
+        printf("Error: failed to open '%s'\n", path);
+        return 1;
+    }
+    const auto noop = [] {};
+    char buffer[256];
+
+    const auto noArgs = [](u64) { LogInfo("Frame started"); };
+    const auto numbers = [](const u64 i) {
+        LogInfo("Frame %llu took %.3f ms, %u draws", CAST<unsigned long long>(i), 16.6, 42U);
+    };
+    const auto string = [&player](const u64 i) {
+        LogInfo("Player %s moved to cell %llu", player, CAST<unsigned long long>(i));
+    };
+    const auto formatOnly = [&buffer](const u64 i) {
+        std::snprintf(buffer,
+                      sizeof(buffer),
+                      "Frame %llu took %.3f ms, %u draws",
+                      CAST<unsigned long long>(i),
+                      16.6,
+                      42U);
+    };
+    const auto writeFlushed = [file](const u64 i) {
+        std::fprintf(file,
+                     "Frame %llu took %.3f ms, %u draws\n",
+                     CAST<unsigned long long>(i),
+                     16.6,
+                     42U);
+        std::fflush(file);
+    };
+
+    printf("%-32s %10s\n", "Call", "ns/call");
+    printf("%-32s %10.1f\n", "LogInfo, no arguments", Measure(calls, noArgs, flushLog));
+    printf("%-32s %10.1f\n", "LogInfo, three numbers", Measure(calls, numbers, flushLog));
+    printf("%-32s %10.1f\n", "LogInfo, string", Measure(calls, string, flushLog));
+    printf("%-32s %10.1f\n", "snprintf, three numbers", Measure(calls, formatOnly, noop));
+    printf("%-32s %10.1f\n", "fprintf + fflush, three numbers", Measure(calls, writeFlushed, noop));
+
+    std::fclose(file);
+    return 0;
+}
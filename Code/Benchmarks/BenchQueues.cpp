@@ -0,0 +1,167 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+// Cross-thread handoff throughput: SpscQueue with one producer, then MpmcQueue and a
+// mutex-protected deque with 1 up to N producers feeding one consumer, each with single and
+// batched pushes and pops.
+//
+// Usage: xen_bench_queues [max producers] [items per producer]
+
+#include "Queue.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+using namespace x;
+using Clock = std::chrono::steady_clock;
+
+static constexpr size_t kCapacity  = 4096;
+static constexpr size_t kBatchSize = 32;
+
+template<typename Queue>
+class LockFreeChannel {
+public:
+    size_t Push(std::span<u64> items) {
+        return items.size() == 1 ? _queue.TryPush(items[0]) : _queue.TryPushBatch(items);
+    }
+
+    size_t Pop(std::span<u64> out) {
+        return out.size() == 1 ? _queue.TryPop(out[0]) : _queue.TryPopBatch(out);
+    }
+
+private:
+    Queue _queue {kCapacity};
+};
+
+// What the lock-free queues replace
+class MutexChannel {
+public:
+    size_t Push(std::span<u64> items) {
+        std::lock_guard lock(_mutex);
+        const size_t count = std::min(items.size(), kCapacity - _items.size());
+        _items.insert(_items.end(), items.begin(), items.begin() + count);
+        return count;
+    }
+
+    size_t Pop(std::span<u64> out) {
+        std::lock_guard lock(_mutex);
+        const size_t count = std::min(out.size(), _items.size());
+        std::copy_n(_items.begin(), count, out.begin());
+        _items.erase(_items.begin(), _items.begin() + count);
+        return count;
+    }
+
+private:
+    std::mutex _mutex;
+    std::deque<u64> _items;
+};
+
+// Runs `producers` threads pushing `perProducer` items each while this thread pops them all, and
+// returns the elapsed seconds, or a negative value if items went missing
+template<typename Channel>
+static f64 Measure(const size_t producers, const size_t perProducer, const size_t batch) {
+    Channel channel;
+    std::atomic<bool> go {false};
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; p++) {
+        threads.emplace_back([&, p] {
+            std::vector<u64> items(batch);
+            u64 next      = p * perProducer;
+            const u64 end = next + perProducer;
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            while (next < end) {
+                const size_t count = std::min<u64>(batch, end - next);
+                for (size_t i = 0; i < count; i++) {
+                    items[i] = next + i;
+                }
+                for (size_t pushed = 0; pushed < count;) {
+                    const size_t n = channel.Push(std::span(items).subspan(pushed, count - pushed));
+                    if (n == 0) { std::this_thread::yield(); }
+                    pushed += n;
+                }
+                next += count;
+            }
+        });
+    }
+
+    const u64 total = producers * perProducer;
+    std::vector<u64> out(batch);
+    u64 received = 0;
+    u64 sum      = 0;
+    const auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    while (received < total) {
+        const size_t n = channel.Pop(out);
+        if (n == 0) { std::this_thread::yield(); }
+        for (size_t i = 0; i < n; i++) {
+            sum += out[i];
+        }
+        received += n;
+    }
+    const f64 seconds = std::chrono::duration<f64>(Clock::now() - start).count();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return sum == total * (total - 1) / 2 ? seconds : -1.0;
+}
+
+template<typename Channel>
+static bool Report(const char* name,
+                   const size_t producers,
+                   const size_t perProducer,
+                   const size_t batch) {
+    const f64 seconds = Measure<Channel>(producers, perProducer, batch);
+    if (seconds < 0) {
+        printf("Error: %s lost or duplicated items\n", name);
+        return false;
+    }
+    const f64 items = CAST<f64>(producers * perProducer);
+    printf("%-30s %9zu %6zu %14.1f %10.1f\n",
+           name,
+           producers,
+           batch,
+           items / seconds / 1e6,
+           seconds * 1e3);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t cores = std::max(std::thread::hardware_concurrency(), 2U);
+    const size_t maxProducers =
+      std::max<size_t>(argc > 1 ? std::strtoull(argv[1], None, 10) : cores - 1, 1);
+    const size_t perProducer = argc > 2 ? std::strtoull(argv[2], None, 10) : 1'000'000;
+
+    printf("%-30s %9s %6s %14s %10s\n", "Queue", "Producers", "Batch", "Mitems/s", "ms");
+
+    bool ok = true;
+    for (const size_t batch : {size_t {1}, kBatchSize}) {
+        ok = Report<LockFreeChannel<SpscQueue<u64>>>("SpscQueue", 1, perProducer, batch) && ok;
+    }
+
+    std::vector<size_t> producerCounts;
+    for (size_t producers = 1; producers < maxProducers; producers *= 2) {
+        producerCounts.push_back(producers);
+    }
+    producerCounts.push_back(maxProducers);
+
+    for (const size_t producers : producerCounts) {
+        for (const size_t batch : {size_t {1}, kBatchSize}) {
+            ok = Report<LockFreeChannel<MpmcQueue<u64>>>("MpmcQueue",
+                                                         producers,
+                                                         perProducer,
+                                                         batch) &&
+                 ok;
+            ok = Report<MutexChannel>("std::mutex + std::deque", producers, perProducer, batch) &&
+                 ok;
+        }
+    }
+    return ok ? 0 : 1;
+}
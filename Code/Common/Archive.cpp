@@ -0,0 +1,413 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#include "Archive.hpp"
+#include "Compression.hpp"
+#include "Hash.hpp"
+
+#include <bit>
+
+namespace x::Filesystem {
+    // The index is used in place from the mapping, so the host has to match the file's byte order
+    static_assert(std::endian::native == std::endian::little,
+                  "Archive reading assumes a little-endian host");
+
+    static u64 AlignUp(const u64 value, const u64 alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    template<typename T>
+    static std::span<const u8> AsBytes(std::span<const T> values) {
+        return {RCAST<const u8*>(values.data()), values.size_bytes()};
+    }
+
+    // Compressed entries are decoded through the chunk table, so it has to describe every entry
+    // exactly: chunks stored inside the file, full ones except for the last, adding up to the
+    // entry's size
+    static bool ValidChunks(std::span<const ArchiveEntry> entries,
+                            std::span<const ArchiveChunk> chunks,
+                            const u32 chunkSize,
+                            const u64 fileSize) {
+        for (const auto& chunk : chunks) {
+            if (chunk.rawSize > chunkSize || chunk.storedSize > chunk.rawSize ||
+                chunk.offset > fileSize || chunk.storedSize > fileSize - chunk.offset) {
+                return false;
+            }
+        }
+        for (const auto& entry : entries) {
+            if (!entry.IsCompressed()) { continue; }
+            if (CAST<u64>(entry.firstChunk) + entry.chunkCount > chunks.size()) { return false; }
+
+            u64 size = 0;
+            for (u32 i = 0; i < entry.chunkCount; i++) {
+                const ArchiveChunk& chunk = chunks[entry.firstChunk + i];
+                const bool last           = i + 1 == entry.chunkCount;
+                if (chunk.rawSize == 0 || (!last && chunk.rawSize != chunkSize)) { return false; }
+                size += chunk.rawSize;
+            }
+            if (size != entry.size) { return false; }
+        }
+        return true;
+    }
+
+#pragma region Archive
+    Archive::Archive(const str& path) {
+        Open(path);
+    }
+
+    bool Archive::Open(const str& path) {
+        Close();
+        if (!_file.Open(path, MappedFile::AccessHint::Random)) { return false; }
+
+        const auto header = _file.Slice(0, sizeof(ArchiveHeader));
+        if (header.empty()) {
+            Close();
+            return false;
+        }
+
+        ArchiveHeader info {};
+        std::memcpy(&info, header.data(), sizeof(ArchiveHeader));
+        const bool validSlots = info.slotCount > 0 && std::has_single_bit(info.slotCount);
+        if (info.magic != kArchiveMagic || info.version != kArchiveVersion || !validSlots ||
+            (info.chunkCount > 0 && info.chunkSize == 0)) {
+            Close();
+            return false;
+        }
+
+        const auto entries =
+          _file.Slice(info.entriesOffset, info.entryCount * sizeof(ArchiveEntry));
+        const auto slots   = _file.Slice(info.slotsOffset, info.slotCount * sizeof(u32));
+        const auto chunks  = _file.Slice(info.chunksOffset, info.chunkCount * sizeof(ArchiveChunk));
+        const auto strings = _file.Slice(info.stringsOffset, info.stringsSize);
+        if ((info.entryCount > 0 && entries.empty()) || slots.empty() ||
+            (info.chunkCount > 0 && chunks.empty()) || (info.stringsSize > 0 && strings.empty())) {
+            Close();
+            return false;
+        }
+        // The tables are used in place, and the mapping itself is page aligned
+        const bool aligned = info.entriesOffset % alignof(ArchiveEntry) == 0 &&
+                             info.slotsOffset % alignof(u32) == 0 &&
+                             info.chunksOffset % alignof(ArchiveChunk) == 0;
+        if (!aligned) {
+            Close();
+            return false;
+        }
+
+        _entries = {RCAST<const ArchiveEntry*>(entries.data()), info.entryCount};
+        _chunks  = {RCAST<const ArchiveChunk*>(chunks.data()), info.chunkCount};
+        if (!ValidChunks(_entries, _chunks, info.chunkSize, _file.Size())) {
+            Close();
+            return false;
+        }
+
+        _slots     = {RCAST<const u32*>(slots.data()), info.slotCount};
+        _strings   = {RCAST<const char*>(strings.data()), strings.size()};
+        _chunkSize = info.chunkSize;
+        return true;
+    }
+
+    void Archive::Close() {
+        _file.Close();
+        _entries   = {};
+        _slots     = {};
+        _chunks    = {};
+        _strings   = {};
+        _chunkSize = 0;
+    }
+
+    bool Archive::IsOpen() const {
+        return !_slots.empty();
+    }
+
+    bool Archive::Contains(std::string_view path) const {
+        return FindEntry(path) != None;
+    }
+
+    const ArchiveEntry* Archive::FindEntry(std::string_view path) const {
+        return FindEntry(Fnv1a64(path), path);
+    }
+
+    const ArchiveEntry* Archive::FindEntry(const PathId path) const {
+        return FindEntry(path.Value(), path.Str());
+    }
+
+    const ArchiveEntry* Archive::FindEntry(const u64 hash, std::string_view path) const {
+        if (_slots.empty()) { return None; }
+
+        // A corrupt archive may have no empty slot at all, so stop once every slot was probed
+        const u64 mask = _slots.size() - 1;
+        u64 slot       = hash & mask;
+        for (size_t probe = 0; probe < _slots.size(); probe++, slot = (slot + 1) & mask) {
+            const u32 index = _slots[slot];
+            if (index == kArchiveEmptySlot || index >= _entries.size()) { return None; }
+            const ArchiveEntry& entry = _entries[index];
+            if (entry.pathHash == hash && GetPath(entry) == path) { return &entry; }
+        }
+        return None;
+    }
+
+    std::span<const u8> Archive::Read(std::string_view path) const {
+        const ArchiveEntry* entry = FindEntry(path);
+        return entry ? Read(*entry) : std::span<const u8> {};
+    }
+
+    std::span<const u8> Archive::Read(const ArchiveEntry& entry) const {
+        if (entry.IsCompressed()) { return {}; }
+        return _file.Slice(entry.offset, entry.size);
+    }
+
+    bool Archive::DecodeChunk(const ArchiveEntry& entry,
+                              const u32 index,
+                              std::span<u8> dest,
+                              const u64 offset) const {
+        const ArchiveChunk& chunk = _chunks[entry.firstChunk + index];
+        const auto stored         = _file.Slice(chunk.offset, chunk.storedSize);
+        if (stored.size() != chunk.storedSize) { return false; }
+
+        // Part of [offset, offset + dest.size()) this chunk covers, relative to the chunk
+        const u64 chunkStart = CAST<u64>(index) * _chunkSize;
+        const u64 begin      = std::max(offset, chunkStart) - chunkStart;
+        const u64 end        = std::min<u64>(offset + dest.size(), chunkStart + chunk.rawSize) -
+                        chunkStart;
+        if (end <= begin) { return false; }
+        u8* out = dest.data() + (chunkStart + begin - offset);
+
+        if (chunk.storedSize == chunk.rawSize) {
+            std::memcpy(out, stored.data() + begin, end - begin);
+            return true;
+        }
+        if (begin == 0 && end == chunk.rawSize) {
+            return Lz4::Decompress(stored, std::span(out, chunk.rawSize));
+        }
+
+        // Partially covered chunk, decode it to scratch memory and copy out the part we need
+        thread_local std::vector<u8> scratch;
+        scratch.resize(chunk.rawSize);
+        if (!Lz4::Decompress(stored, scratch)) { return false; }
+        std::memcpy(out, scratch.data() + begin, end - begin);
+        return true;
+    }
+
+    bool Archive::ReadBlock(const ArchiveEntry& entry, std::span<u8> dest, const u64 offset) const {
+        if (offset > entry.size || dest.size() > entry.size - offset) { return false; }
+        if (dest.empty()) { return true; }
+
+        if (!entry.IsCompressed()) {
+            const auto data = _file.Slice(entry.offset + offset, dest.size());
+            if (data.size() != dest.size()) { return false; }
+            std::memcpy(dest.data(), data.data(), dest.size());
+            return true;
+        }
+
+        if (CAST<u64>(entry.firstChunk) + entry.chunkCount > _chunks.size()) { return false; }
+        const auto first = CAST<u32>(offset / _chunkSize);
+        const auto last  = CAST<u32>((offset + dest.size() - 1) / _chunkSize);
+        const u32 count  = last - first + 1;
+        if (last >= entry.chunkCount) { return false; }
+
+        if (count == 1) { return DecodeChunk(entry, first, dest, offset); }
+
+        // Workers and the calling thread all pull chunk indices from the same counter. The caller
+        // never waits on a chunk nobody has claimed, so this can't deadlock when the pool is busy
+        // (or when called from inside a pool job); the helpers just end up with nothing to do.
+        struct Decode {
+            std::atomic<u32> next {0};
+            std::atomic<u32> done {0};
+            std::atomic<bool> ok {true};
+        };
+        auto state = make_shared<Decode>();
+
+        auto work = [this, &entry, dest, offset, first, count](Decode& decode) {
+            for (u32 i = decode.next.fetch_add(1); i < count; i = decode.next.fetch_add(1)) {
+                if (!DecodeChunk(entry, first + i, dest, offset)) { decode.ok = false; }
+                if (decode.done.fetch_add(1) + 1 == count) { decode.done.notify_all(); }
+            }
+        };
+
+        auto& pool        = IoPool::Get();
+        const u32 helpers = std::min(count - 1, pool.GetWorkerCount());
+        for (u32 i = 0; i < helpers; i++) {
+            // The helper only touches `this`, `entry` and `dest` after claiming a chunk, and all
+            // chunks are claimed and finished before ReadBlock() returns
+            auto helper = [state, work]() { work(*state); };
+            if (!pool.TrySubmit(helper, IoPriority::Streaming)) { break; }
+        }
+        work(*state);
+
+        for (u32 done = state->done.load(); done < count; done = state->done.load()) {
+            state->done.wait(done);
+        }
+        return state->ok;
+    }
+
+    std::vector<u8> Archive::ReadAllBytes(std::string_view path) const {
+        const ArchiveEntry* entry = FindEntry(path);
+        if (!entry) { return {}; }
+        std::vector<u8> bytes(entry->size);
+        if (!ReadBlock(*entry, bytes)) { return {}; }
+        return bytes;
+    }
+
+    std::span<const ArchiveEntry> Archive::GetEntries() const {
+        return _entries;
+    }
+
+    std::string_view Archive::GetPath(const ArchiveEntry& entry) const {
+        if (CAST<u64>(entry.pathOffset) + entry.pathLength > _strings.size()) { return {}; }
+        return _strings.substr(entry.pathOffset, entry.pathLength);
+    }
+#pragma endregion
+
+#pragma region ArchiveBuilder
+    void ArchiveBuilder::AddFile(const str& archivePath,
+                                 const str& sourcePath,
+                                 const bool compress) {
+        _sources[archivePath] = {sourcePath, {}, compress};
+    }
+
+    void
+    ArchiveBuilder::AddBytes(const str& archivePath, std::vector<u8> data, const bool compress) {
+        _sources[archivePath] = {{}, std::move(data), compress};
+    }
+
+    void ArchiveBuilder::SetChunkSize(const u32 chunkSize) {
+        _chunkSize = std::max<u32>(chunkSize, 4096);
+    }
+
+    bool ArchiveBuilder::Write(const str& outputPath) const {
+        struct Blob {
+            std::span<const u8> raw;
+            std::vector<u8> compressed;   // All chunks back to back, empty if stored raw
+            std::vector<u32> chunkSizes;  // Stored size of each chunk
+        };
+
+        // Map and compress every source up front so blob sizes, and therefore offsets, are known
+        // before any of the index gets written
+        std::vector<MappedFile> mappings(_sources.size());
+        std::vector<Blob> blobs(_sources.size());
+        std::vector<u8> scratch(Lz4::CompressBound(_chunkSize));
+
+        u64 stringsSize = 0;
+        u32 chunkCount  = 0;
+        size_t i        = 0;
+        for (const auto& [archivePath, source] : _sources) {
+            Blob& blob = blobs[i];
+            if (source.sourcePath.empty()) {
+                blob.raw = source.data;
+            } else {
+                if (!mappings[i].Open(source.sourcePath, MappedFile::AccessHint::Sequential)) {
+                    return false;
+                }
+                blob.raw = mappings[i].Data();
+            }
+            stringsSize += archivePath.size();
+            i++;
+
+            if (!source.compress || blob.raw.empty()) { continue; }
+            auto& out = blob.compressed;
+            for (u64 offset = 0; offset < blob.raw.size(); offset += _chunkSize) {
+                const auto chunk =
+                  blob.raw.subspan(offset, std::min<u64>(_chunkSize, blob.raw.size() - offset));
+                const size_t size = Lz4::Compress(chunk, scratch);
+                if (size > 0 && size < chunk.size()) {
+                    out.insert(out.end(), scratch.begin(), scratch.begin() + CAST<i64>(size));
+                    blob.chunkSizes.push_back(CAST<u32>(size));
+                } else {
+                    out.insert(out.end(), chunk.begin(), chunk.end());
+                    blob.chunkSizes.push_back(CAST<u32>(chunk.size()));
+                }
+            }
+            if (blob.compressed.size() >= blob.raw.size()) {
+                // Didn't pay off, keep it uncompressed so it can be read without a copy
+                blob.compressed.clear();
+                blob.chunkSizes.clear();
+            }
+            chunkCount += CAST<u32>(blob.chunkSizes.size());
+        }
+
+        u32 slotCount = 16;
+        while (slotCount < _sources.size() * 2) {
+            slotCount <<= 1;  // Keep the load factor under 0.5 so probes stay short
+        }
+
+        ArchiveHeader header {};
+        header.magic         = kArchiveMagic;
+        header.version       = kArchiveVersion;
+        header.entryCount    = CAST<u32>(_sources.size());
+        header.slotCount     = slotCount;
+        header.chunkCount    = chunkCount;
+        header.chunkSize     = _chunkSize;
+        header.entriesOffset = sizeof(ArchiveHeader);
+        header.slotsOffset   = header.entriesOffset + header.entryCount * sizeof(ArchiveEntry);
+        header.chunksOffset  = header.slotsOffset + slotCount * sizeof(u32);
+        header.stringsOffset = header.chunksOffset + chunkCount * sizeof(ArchiveChunk);
+        header.stringsSize   = stringsSize;
+
+        std::vector<ArchiveEntry> entries;
+        std::vector<ArchiveChunk> chunks;
+        std::vector<u32> slots(slotCount, kArchiveEmptySlot);
+        entries.reserve(_sources.size());
+        chunks.reserve(chunkCount);
+
+        u64 dataOffset = AlignUp(header.stringsOffset + stringsSize, kArchiveAlignment);
+        u32 pathOffset = 0;
+        i              = 0;
+        for (const auto& [archivePath, _] : _sources) {
+            const Blob& blob = blobs[i++];
+            ArchiveEntry entry {};
+            entry.pathHash   = Fnv1a64(archivePath);
+            entry.offset     = dataOffset;
+            entry.size       = blob.raw.size();
+            entry.storedSize = blob.compressed.empty() ? blob.raw.size() : blob.compressed.size();
+            entry.pathOffset = pathOffset;
+            entry.pathLength = CAST<u32>(archivePath.size());
+            entry.firstChunk = CAST<u32>(chunks.size());
+            entry.chunkCount = CAST<u32>(blob.chunkSizes.size());
+
+            u64 chunkOffset = dataOffset;
+            for (size_t c = 0; c < blob.chunkSizes.size(); c++) {
+                const u64 rawSize = std::min<u64>(_chunkSize, entry.size - c * _chunkSize);
+                chunks.push_back({chunkOffset, blob.chunkSizes[c], CAST<u32>(rawSize)});
+                chunkOffset += blob.chunkSizes[c];
+            }
+
+            u64 slot = entry.pathHash & (slotCount - 1);
+            while (slots[slot] != kArchiveEmptySlot) {
+                slot = (slot + 1) & (slotCount - 1);
+            }
+            slots[slot] = CAST<u32>(entries.size());
+            entries.push_back(entry);
+
+            dataOffset = AlignUp(dataOffset + entry.storedSize, kArchiveAlignment);
+            pathOffset += entry.pathLength;
+        }
+
+        // Gathered straight from where everything already lives, blobs aren't copied again
+        static constexpr u8 kPadding[kArchiveAlignment] = {};
+        std::vector<std::span<const u8>> parts;
+        parts.reserve(4 + _sources.size() * 3);
+        parts.push_back(AsBytes(std::span<const ArchiveHeader>(&header, 1)));
+        parts.push_back(AsBytes<ArchiveEntry>(entries));
+        parts.push_back(AsBytes<u32>(slots));
+        parts.push_back(AsBytes<ArchiveChunk>(chunks));
+        for (const auto& [archivePath, _] : _sources) {
+            parts.push_back(AsBytes<char>(archivePath));
+        }
+
+        u64 written = header.stringsOffset + stringsSize;
+        for (size_t e = 0; e < entries.size(); e++) {
+            parts.push_back(std::span(kPadding, entries[e].offset - written));
+            parts.push_back(blobs[e].compressed.empty() ? blobs[e].raw
+                                                        : std::span<const u8>(blobs[e].compressed));
+            written = entries[e].offset + entries[e].storedSize;
+        }
+
+        return FileWriter::WriteAllBytes(outputPath, parts);
+    }
+
+    size_t ArchiveBuilder::GetEntryCount() const {
+        return _sources.size();
+    }
+#pragma endregion
+}  // namespace x::Filesystem
@@ -0,0 +1,144 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Types.hpp"
+#include "Filesystem.hpp"
+
+#include <map>
+#include <span>
+#include <string_view>
+
+namespace x::Filesystem {
+    // Layout of a .xpak file, all values little-endian:
+    //
+    //   ArchiveHeader
+    //   ArchiveEntry[entryCount]   sorted by path
+    //   u32[slotCount]             open addressing table of entry indices keyed by path hash
+    //   ArchiveChunk[chunkCount]   chunk tables of the compressed entries, back to back
+    //   char[stringsSize]          entry paths, not null terminated
+    //   blobs                      each one starts on a kArchiveAlignment boundary
+    //
+    // A compressed entry's blob is its chunks stored back to back. Every chunk covers chunkSize
+    // bytes of the original file (the last one may be shorter) and is compressed on its own, so
+    // reading a range only has to decode the chunks it overlaps.
+    static constexpr u32 kArchiveMagic            = 0x4B415058;  // "XPAK"
+    static constexpr u16 kArchiveVersion          = 2;
+    static constexpr u64 kArchiveAlignment        = 4096;
+    static constexpr u32 kArchiveEmptySlot        = 0xFFFFFFFF;
+    static constexpr u32 kArchiveDefaultChunkSize = 128 * 1024;
+
+    struct ArchiveHeader {
+        u32 magic;
+        u16 version;
+        u16 flags;
+        u32 entryCount;
+        u32 slotCount;  // Always a power of two
+        u32 chunkCount;
+        u32 chunkSize;
+        u64 entriesOffset;
+        u64 slotsOffset;
+        u64 chunksOffset;
+        u64 stringsOffset;
+        u64 stringsSize;
+    };
+
+    struct ArchiveEntry {
+        u64 pathHash;
+        u64 offset;      // Absolute offset of the blob in the archive
+        u64 size;        // Uncompressed size
+        u64 storedSize;  // Size of the blob, equal to size for uncompressed entries
+        u32 pathOffset;  // Into the string table
+        u32 pathLength;
+        u32 firstChunk;
+        u32 chunkCount;  // 0 for entries stored uncompressed
+
+        [[nodiscard]] bool IsCompressed() const {
+            return chunkCount > 0;
+        }
+    };
+
+    struct ArchiveChunk {
+        u64 offset;  // Absolute offset of the chunk in the archive
+        u32 storedSize;
+        u32 rawSize;  // Chunks that didn't compress are stored as-is, with storedSize == rawSize
+    };
+
+    static_assert(sizeof(ArchiveHeader) == 64);
+    static_assert(sizeof(ArchiveEntry) == 48);
+    static_assert(sizeof(ArchiveChunk) == 16);
+
+    /// Read-only view of a .xpak archive. The whole file is mapped once on Open(), after which a
+    /// lookup is a hash plus a probe or two, with no syscalls. Paths use '/' separators and are
+    /// relative to the archive root, e.g. "Shaders/Unlit.vert.spv".
+    class Archive {
+    public:
+        Archive() = default;
+        explicit Archive(const str& path);
+
+        bool Open(const str& path);
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const;
+        [[nodiscard]] bool Contains(std::string_view path) const;
+        [[nodiscard]] const ArchiveEntry* FindEntry(std::string_view path) const;
+        /// Skips hashing, PathId already carries the archive's path hash.
+        [[nodiscard]] const ArchiveEntry* FindEntry(PathId path) const;
+
+        /// Returns a view of the file's bytes inside the mapping, or an empty span if the archive
+        /// doesn't contain `path` or the entry is compressed. Blobs are page aligned, so they can
+        /// go straight to Vulkan.
+        [[nodiscard]] std::span<const u8> Read(std::string_view path) const;
+        [[nodiscard]] std::span<const u8> Read(const ArchiveEntry& entry) const;
+
+        /// Copies `dest.size()` bytes starting at `offset` of the uncompressed file into `dest`.
+        /// Only the chunks overlapping the range are decompressed, and reads spanning several
+        /// chunks decode them in parallel on the IoPool.
+        bool ReadBlock(const ArchiveEntry& entry, std::span<u8> dest, u64 offset = 0) const;
+        [[nodiscard]] std::vector<u8> ReadAllBytes(std::string_view path) const;
+
+        [[nodiscard]] std::span<const ArchiveEntry> GetEntries() const;
+        [[nodiscard]] std::string_view GetPath(const ArchiveEntry& entry) const;
+
+    private:
+        const ArchiveEntry* FindEntry(u64 hash, std::string_view path) const;
+        bool
+        DecodeChunk(const ArchiveEntry& entry, u32 index, std::span<u8> dest, u64 offset) const;
+
+        MappedFile _file;
+        std::span<const ArchiveEntry> _entries;
+        std::span<const u32> _slots;
+        std::span<const ArchiveChunk> _chunks;
+        std::string_view _strings;
+        u32 _chunkSize = 0;
+    };
+
+    /// Collects files and writes them out as a .xpak archive.
+    class ArchiveBuilder {
+    public:
+        /// Adds a file from disk, it's only read when Write() is called. Compressed files are
+        /// stored uncompressed anyway if LZ4 doesn't shrink them.
+        void AddFile(const str& archivePath, const str& sourcePath, bool compress = false);
+        void AddBytes(const str& archivePath, std::vector<u8> data, bool compress = false);
+
+        /// Uncompressed bytes per chunk of compressed entries, 64-256 KB is a good range.
+        void SetChunkSize(u32 chunkSize);
+
+        bool Write(const str& outputPath) const;
+
+        [[nodiscard]] size_t GetEntryCount() const;
+
+    private:
+        struct Source {
+            str sourcePath;
+            std::vector<u8> data;  // Used when sourcePath is empty
+            bool compress;
+        };
+
+        // Ordered so the written archive is deterministic
+        std::map<str, Source, std::less<>> _sources;
+        u32 _chunkSize = kArchiveDefaultChunkSize;
+    };
+}  // namespace x::Filesystem
@@ -0,0 +1,106 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#include "Arena.hpp"
+#include "Panic.inl"
+
+#include <algorithm>
+
+namespace x {
+#pragma region LinearArena
+    LinearArena::LinearArena(const size_t capacity)
+        : _block(std::make_unique_for_overwrite<u8[]>(capacity)), _capacity(capacity),
+          _heapAllocations(1) {}
+
+    void* LinearArena::AllocateSlow(const size_t size, const size_t alignment) {
+        size_t start = 0;
+        if (!_overflow.empty()) {
+            start = AlignOffset(_overflow.back().get(), _overflowOffset, alignment);
+        }
+        if (_overflow.empty() || start + size > _overflowCapacity) {
+            // At least as big as the main block, so a burst doesn't take one block per allocation
+            _overflowCapacity = std::max(size + alignment, _capacity);
+            _overflow.push_back(std::make_unique_for_overwrite<u8[]>(_overflowCapacity));
+            _heapAllocations++;
+            _overflowOffset = 0;
+            start           = AlignOffset(_overflow.back().get(), 0, alignment);
+        }
+
+        _overflowUsed += start + size - _overflowOffset;
+        _overflowOffset = start + size;
+        return _overflow.back().get() + start;
+    }
+
+    void LinearArena::Free(void* ptr, const size_t size) {
+        const u8* end = CAST<u8*>(ptr) + size;
+        if (end == _block.get() + _offset) {
+            _offset -= size;
+        } else if (!_overflow.empty() && end == _overflow.back().get() + _overflowOffset) {
+            _overflowOffset -= size;
+            _overflowUsed -= size;
+        }
+    }
+
+    void LinearArena::Reset() {
+        if (!_overflow.empty()) {
+            // Grow to the peak of this round, with some headroom so a slowly growing workload
+            // doesn't reallocate every frame
+            const size_t peak = _offset + _overflowUsed;
+            _capacity         = std::max(peak + peak / 4, _capacity * 2);
+            _overflow.clear();
+            _block.reset();  // Free before allocating so the peak footprint doesn't double
+            _block = std::make_unique_for_overwrite<u8[]>(_capacity);
+            _heapAllocations++;
+            _overflowCapacity = 0;
+            _overflowOffset   = 0;
+            _overflowUsed     = 0;
+        }
+        _offset = 0;
+    }
+
+    size_t LinearArena::Used() const {
+        return _offset + _overflowUsed;
+    }
+
+    size_t LinearArena::Capacity() const {
+        return _capacity;
+    }
+
+    u64 LinearArena::GetHeapAllocationCount() const {
+        return _heapAllocations;
+    }
+#pragma endregion
+
+#pragma region FrameArena
+    FrameArena::FrameArena(const u32 framesInFlight, const size_t capacityPerFrame) {
+        if (framesInFlight == 0) { Panic("FrameArena needs at least one frame in flight."); }
+        _arenas.reserve(framesInFlight);
+        for (u32 i = 0; i < framesInFlight; i++) {
+            _arenas.emplace_back(capacityPerFrame);
+        }
+    }
+
+    LinearArena& FrameArena::BeginFrame(const u32 frameIndex) {
+        _current = frameIndex % CAST<u32>(_arenas.size());
+        _arenas[_current].Reset();
+        return _arenas[_current];
+    }
+
+    LinearArena& FrameArena::Current() {
+        return _arenas[_current];
+    }
+
+    u32 FrameArena::GetFrameCount() const {
+        return CAST<u32>(_arenas.size());
+    }
+
+    u64 FrameArena::GetHeapAllocationCount() const {
+        u64 count = 0;
+        for (const auto& arena : _arenas) {
+            count += arena.GetHeapAllocationCount();
+        }
+        return count;
+    }
+#pragma endregion
+}  // namespace x
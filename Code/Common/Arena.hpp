@@ -0,0 +1,148 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Types.hpp"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace x {
+    /// Bump allocator for scratch data that all dies at once, like everything built while
+    /// recording a frame. Allocating is a pointer bump and Reset() releases everything in O(1).
+    /// Destructors never run, so only trivially destructible types can be created with New().
+    ///
+    /// When the block runs out the arena falls back to extra heap blocks, and the next Reset()
+    /// replaces the block with one big enough for the peak, so a steady workload stops touching
+    /// the heap after its first few frames. Not thread-safe.
+    class LinearArena {
+    public:
+        static constexpr size_t kDefaultCapacity = 1 << 20;
+
+        explicit LinearArena(size_t capacity = kDefaultCapacity);
+
+        LinearArena(const LinearArena&)            = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+
+        LinearArena(LinearArena&&) noexcept            = default;
+        LinearArena& operator=(LinearArena&&) noexcept = default;
+
+        void* Allocate(const size_t size, const size_t alignment = alignof(std::max_align_t)) {
+            const size_t start = AlignOffset(_block.get(), _offset, alignment);
+            if (start + size <= _capacity) {
+                _offset = start + size;
+                return _block.get() + start;
+            }
+            return AllocateSlow(size, alignment);
+        }
+
+        /// Uninitialized storage for `count` objects of type T.
+        template<typename T>
+        T* Allocate(const size_t count) {
+            if (count > SIZE_MAX / sizeof(T)) { throw std::bad_array_new_length(); }
+            return CAST<T*>(Allocate(count * sizeof(T), alignof(T)));
+        }
+
+        template<typename T, typename... Args>
+        T* New(Args&&... args) {
+            static_assert(std::is_trivially_destructible_v<T>,
+                          "LinearArena never runs destructors");
+            return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        /// Gives back `size` bytes at `ptr` if they were the most recent allocation, which lets a
+        /// container that grows right after allocating reuse the space. Anything else is a no-op.
+        void Free(void* ptr, size_t size);
+
+        /// Releases every allocation. Only touches the heap if the previous round outgrew the
+        /// block.
+        void Reset();
+
+        [[nodiscard]] size_t Used() const;
+        [[nodiscard]] size_t Capacity() const;
+        /// Heap allocations made since construction, including the initial block.
+        [[nodiscard]] u64 GetHeapAllocationCount() const;
+
+    private:
+        // Offset of the first address at or past `base + offset` that is aligned to `alignment`
+        static size_t AlignOffset(const u8* base, const size_t offset, const size_t alignment) {
+            const uintptr_t address = RCAST<uintptr_t>(base) + offset;
+            return offset + ((alignment - address % alignment) & (alignment - 1));
+        }
+
+        void* AllocateSlow(size_t size, size_t alignment);
+
+        unique_ptr<u8[]> _block;
+        size_t _capacity = 0;
+        size_t _offset   = 0;
+
+        // Blocks taken from the heap after _block ran out, freed on Reset()
+        vector<unique_ptr<u8[]>> _overflow;
+        size_t _overflowCapacity = 0;  // Size of the newest overflow block
+        size_t _overflowOffset   = 0;
+        size_t _overflowUsed     = 0;  // Bytes handed out from all overflow blocks
+        u64 _heapAllocations     = 0;
+    };
+
+    /// STL allocator over a LinearArena. Deallocation only reclaims the most recent allocation,
+    /// so reserve() containers up front when the final size is known.
+    template<typename T>
+    class ArenaAllocator {
+    public:
+        using value_type = T;
+
+        ArenaAllocator(LinearArena& arena) noexcept : _arena(&arena) {}
+
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept : _arena(other.GetArena()) {}
+
+        T* allocate(const size_t count) {
+            return _arena->Allocate<T>(count);
+        }
+
+        void deallocate(T* ptr, const size_t count) noexcept {
+            _arena->Free(ptr, count * sizeof(T));
+        }
+
+        [[nodiscard]] LinearArena* GetArena() const noexcept {
+            return _arena;
+        }
+
+        template<typename U>
+        bool operator==(const ArenaAllocator<U>& other) const noexcept {
+            return _arena == other.GetArena();
+        }
+
+    private:
+        LinearArena* _arena;
+    };
+
+    /// Vector living in a LinearArena, e.g. `ArenaVector<VkImageMemoryBarrier> barriers(arena)`.
+    /// It must not outlive the arena's next Reset().
+    template<typename T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+    /// One LinearArena per frame in flight. Once the fence of a frame slot has signaled, call
+    /// BeginFrame() with its index: that releases whatever the slot allocated last time it was
+    /// recorded, while the other slots' data stays alive for the GPU frames still using it.
+    class FrameArena {
+    public:
+        explicit FrameArena(u32 framesInFlight      = 2,
+                            size_t capacityPerFrame = LinearArena::kDefaultCapacity);
+
+        /// Resets the arena of `frameIndex` and makes it the current one.
+        LinearArena& BeginFrame(u32 frameIndex);
+        /// The arena of the frame being recorded.
+        LinearArena& Current();
+
+        [[nodiscard]] u32 GetFrameCount() const;
+        [[nodiscard]] u64 GetHeapAllocationCount() const;
+
+    private:
+        vector<LinearArena> _arenas;
+        u32 _current = 0;
+    };
+}  // namespace x
@@ -0,0 +1,79 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#include "BufferPool.hpp"
+
+namespace x::Filesystem {
+#pragma region PooledBuffer
+    PooledBuffer::PooledBuffer(BufferPool* pool, unique_ptr<u8[]> data, const size_t size)
+        : _pool(pool), _data(std::move(data)), _size(size) {}
+
+    PooledBuffer::~PooledBuffer() {
+        Release();
+    }
+
+    PooledBuffer::PooledBuffer(PooledBuffer&& other) noexcept
+        : _pool(other._pool), _data(std::move(other._data)), _size(other._size) {
+        other._pool = None;
+        other._size = 0;
+    }
+
+    PooledBuffer& PooledBuffer::operator=(PooledBuffer&& other) noexcept {
+        if (this != &other) {
+            Release();
+            _pool       = other._pool;
+            _data       = std::move(other._data);
+            _size       = other._size;
+            other._pool = None;
+            other._size = 0;
+        }
+        return *this;
+    }
+
+    void PooledBuffer::Release() {
+        if (_pool && _data) { _pool->Return(std::move(_data)); }
+        _pool = None;
+        _data = None;
+        _size = 0;
+    }
+#pragma endregion
+
+#pragma region BufferPool
+    BufferPool::BufferPool(const size_t bufferSize, const size_t maxFree)
+        : _bufferSize(bufferSize), _maxFree(maxFree) {}
+
+    PooledBuffer BufferPool::Acquire() {
+        {
+            std::lock_guard lock(_mutex);
+            if (!_free.empty()) {
+                auto data = std::move(_free.back());
+                _free.pop_back();
+                return {this, std::move(data), _bufferSize};
+            }
+            _allocations++;
+        }
+        // Uninitialized on purpose, it's about to be read into
+        return {this, unique_ptr<u8[]>(new u8[_bufferSize]), _bufferSize};
+    }
+
+    size_t BufferPool::GetBufferSize() const {
+        return _bufferSize;
+    }
+
+    size_t BufferPool::GetFreeCount() const {
+        std::lock_guard lock(_mutex);
+        return _free.size();
+    }
+
+    u64 BufferPool::GetAllocationCount() const {
+        std::lock_guard lock(_mutex);
+        return _allocations;
+    }
+
+    void BufferPool::Return(unique_ptr<u8[]> data) {
+        std::lock_guard lock(_mutex);
+        if (_free.size() < _maxFree) { _free.push_back(std::move(data)); }
+    }
+#pragma endregion
+}  // namespace x::Filesystem
@@ -0,0 +1,82 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Types.hpp"
+
+#include <mutex>
+#include <span>
+
+namespace x::Filesystem {
+    class BufferPool;
+
+    /// A buffer borrowed from a BufferPool, handed back to it on destruction.
+    class PooledBuffer {
+    public:
+        PooledBuffer() = default;
+        ~PooledBuffer();
+
+        PooledBuffer(const PooledBuffer&)            = delete;
+        PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+        PooledBuffer(PooledBuffer&& other) noexcept;
+        PooledBuffer& operator=(PooledBuffer&& other) noexcept;
+
+        [[nodiscard]] bool IsValid() const {
+            return _data != None;
+        }
+
+        [[nodiscard]] u8* Data() const {
+            return _data.get();
+        }
+
+        [[nodiscard]] size_t Size() const {
+            return _size;
+        }
+
+        [[nodiscard]] std::span<u8> Span() const {
+            return {_data.get(), _size};
+        }
+
+        /// Hands the buffer back early.
+        void Release();
+
+    private:
+        friend class BufferPool;
+        PooledBuffer(BufferPool* pool, unique_ptr<u8[]> data, size_t size);
+
+        BufferPool* _pool = None;
+        unique_ptr<u8[]> _data;
+        size_t _size = 0;
+    };
+
+    /// Recycles fixed-size I/O buffers, so a streaming loop that reads chunk after chunk only
+    /// allocates until it has as many buffers as it keeps in flight. The pool must outlive the
+    /// buffers it hands out.
+    class BufferPool {
+    public:
+        explicit BufferPool(size_t bufferSize, size_t maxFree = 64);
+
+        BufferPool(const BufferPool&)            = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+
+        /// Returns a free buffer, or allocates a new one if there is none.
+        PooledBuffer Acquire();
+
+        [[nodiscard]] size_t GetBufferSize() const;
+        [[nodiscard]] size_t GetFreeCount() const;
+        [[nodiscard]] u64 GetAllocationCount() const;
+
+    private:
+        friend class PooledBuffer;
+        void Return(unique_ptr<u8[]> data);
+
+        const size_t _bufferSize;
+        const size_t _maxFree;  // Buffers returned beyond this are freed
+        mutable std::mutex _mutex;
+        vector<unique_ptr<u8[]>> _free;
+        u64 _allocations = 0;
+    };
+}  // namespace x::Filesystem
@@ -0,0 +1,179 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#include "Compression.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace x {
+    static constexpr size_t kMinMatch     = 4;
+    static constexpr size_t kLastLiterals = 5;   // The block must end in at least 5 literals
+    static constexpr size_t kMatchLimit   = 12;  // and the last match must start before this
+    static constexpr size_t kMaxOffset    = 65535;
+    static constexpr u32 kHashBits        = 12;
+
+    // Copies in 16 byte steps and may write up to 15 bytes past `dst + length`. Only used when
+    // there's that much room left, the overshoot gets overwritten by the following sequences.
+    static constexpr size_t kWildCopy = 16;
+
+    static void WildCopy(u8* dst, const u8* src, const size_t length) {
+        for (size_t copied = 0; copied < length; copied += kWildCopy) {
+            std::memcpy(dst + copied, src + copied, kWildCopy);
+        }
+    }
+
+    static u32 Read32(const u8* ptr) {
+        u32 value;
+        std::memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    static u32 HashSequence(const u32 sequence) {
+        return (sequence * 2654435761U) >> (32 - kHashBits);
+    }
+
+    // Writes the 255-run encoding of a length that didn't fit in its token nibble
+    static u8* WriteLength(u8* op, size_t length) {
+        for (; length >= 255; length -= 255) {
+            *op++ = 255;
+        }
+        *op++ = CAST<u8>(length);
+        return op;
+    }
+
+    size_t Lz4::CompressBound(const size_t size) {
+        return size + size / 255 + 16;
+    }
+
+    size_t Lz4::Compress(std::span<const u8> src, std::span<u8> dst) {
+        if (dst.size() < CompressBound(src.size())) { return 0; }
+
+        const u8* const base = src.data();
+        const u8* const iend = base + src.size();
+        const u8* ip         = base;
+        const u8* anchor     = base;
+        u8* op               = dst.data();
+
+        auto emitSequence = [&](const u8* literalEnd, const size_t offset, const size_t matchLen) {
+            const size_t literalLen = CAST<size_t>(literalEnd - anchor);
+            u8* token               = op++;
+            *token                  = CAST<u8>(std::min<size_t>(literalLen, 15) << 4);
+            if (literalLen >= 15) { op = WriteLength(op, literalLen - 15); }
+            if (literalLen > 0) { std::memcpy(op, anchor, literalLen); }
+            op += literalLen;
+            if (matchLen == 0) { return; }  // Final literal-only sequence
+
+            *op++                 = CAST<u8>(offset & 0xFF);
+            *op++                 = CAST<u8>(offset >> 8);
+            const size_t matchExt = matchLen - kMinMatch;
+            *token |= CAST<u8>(std::min<size_t>(matchExt, 15));
+            if (matchExt >= 15) { op = WriteLength(op, matchExt - 15); }
+        };
+
+        if (src.size() > kMatchLimit) {
+            u32 table[1 << kHashBits] = {};
+            const u8* const mflimit   = iend - kMatchLimit;
+            const u8* const matchEnd  = iend - kLastLiterals;
+
+            u32 misses = 0;
+            while (ip < mflimit) {
+                const u32 sequence = Read32(ip);
+                const u32 hash     = HashSequence(sequence);
+                const u8* ref      = base + table[hash];
+                table[hash]        = CAST<u32>(ip - base);
+
+                if (ref >= ip || CAST<size_t>(ip - ref) > kMaxOffset || Read32(ref) != sequence) {
+                    // Skip ahead faster the longer we go without a match, incompressible data
+                    // would otherwise cost a hash probe per byte
+                    ip += 1 + (misses++ >> 6);
+                    continue;
+                }
+                misses = 0;
+
+                while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+                    ip--;
+                    ref--;
+                }
+
+                size_t matchLen = kMinMatch;
+                while (ip + matchLen < matchEnd && ip[matchLen] == ref[matchLen]) {
+                    matchLen++;
+                }
+
+                emitSequence(ip, CAST<size_t>(ip - ref), matchLen);
+                ip += matchLen;
+                anchor = ip;
+
+                // Seed the table inside the match so the next position can find it
+                if (ip < mflimit) {
+                    table[HashSequence(Read32(ip - 2))] = CAST<u32>(ip - 2 - base);
+                }
+            }
+        }
+
+        emitSequence(iend, 0, 0);
+        return CAST<size_t>(op - dst.data());
+    }
+
+    bool Lz4::Decompress(std::span<const u8> src, std::span<u8> dst) {
+        const u8* ip         = src.data();
+        const u8* const iend = ip + src.size();
+        u8* op               = dst.data();
+        u8* const oend       = op + dst.size();
+
+        auto readLength = [&](size_t& length) {
+            u8 byte;
+            do {
+                if (ip >= iend) { return false; }
+                byte = *ip++;
+                length += byte;
+            } while (byte == 255);
+            return true;
+        };
+
+        while (ip < iend) {
+            const u8 token = *ip++;
+
+            size_t literalLen = token >> 4;
+            if (literalLen == 15 && !readLength(literalLen)) { return false; }
+            if (literalLen > CAST<size_t>(iend - ip) || literalLen > CAST<size_t>(oend - op)) {
+                return false;
+            }
+            if (literalLen + kWildCopy <= CAST<size_t>(iend - ip) &&
+                literalLen + kWildCopy <= CAST<size_t>(oend - op)) {
+                WildCopy(op, ip, literalLen);
+            } else if (literalLen > 0) {
+                std::memcpy(op, ip, literalLen);
+            }
+            ip += literalLen;
+            op += literalLen;
+            if (ip == iend) { break; }  // The last sequence has no match
+
+            if (iend - ip < 2) { return false; }
+            const size_t offset = ip[0] | (CAST<size_t>(ip[1]) << 8);
+            ip += 2;
+            if (offset == 0 || offset > CAST<size_t>(op - dst.data())) { return false; }
+
+            size_t matchLen = token & 15;
+            if (matchLen == 15 && !readLength(matchLen)) { return false; }
+            matchLen += kMinMatch;
+            if (matchLen > CAST<size_t>(oend - op)) { return false; }
+
+            const u8* match = op - offset;
+            if (offset >= kWildCopy && matchLen + kWildCopy <= CAST<size_t>(oend - op)) {
+                // Every 16 byte step only reads bytes that were final before it started, so this
+                // is safe for overlapping matches as long as they're at least 16 bytes back
+                WildCopy(op, match, matchLen);
+            } else {
+                for (size_t i = 0; i < matchLen; i++) {
+                    op[i] = match[i];
+                }
+            }
+            op += matchLen;
+        }
+
+        return op == oend;
+    }
+}  // namespace x
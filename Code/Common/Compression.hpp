@@ -0,0 +1,26 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Types.hpp"
+
+#include <span>
+
+namespace x {
+    /// LZ4 block format codec. Greedy single-probe matcher, so it trades some ratio for speed the
+    /// same way LZ4's default mode does. Output is readable by the reference LZ4 decoder.
+    class Lz4 {
+    public:
+        /// Worst case compressed size for `size` input bytes.
+        static size_t CompressBound(size_t size);
+
+        /// Compresses `src` into `dst`, returns the compressed size or 0 if `dst` is too small.
+        static size_t Compress(std::span<const u8> src, std::span<u8> dst);
+
+        /// Decompresses `src` into `dst`, which must be exactly the uncompressed size. Returns
+        /// false on malformed input instead of reading or writing out of bounds.
+        static bool Decompress(std::span<const u8> src, std::span<u8> dst);
+    };
+}  // namespace x
@@ -0,0 +1,197 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#include "ContentCache.hpp"
+#include "Hash.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#ifdef _WIN32
+    #include <sys/utime.h>
+#else
+    #include <fcntl.h>
+    #include <sys/stat.h>
+#endif
+
+namespace x::Filesystem {
+    // Temp files older than this were left behind by a crash in the middle of a Store()
+    static constexpr i64 kStaleTempNs = 10LL * 60 * 1'000'000'000;
+
+    static constexpr std::string_view kHexDigits = "0123456789abcdef";
+
+    static std::optional<u128> ParseKey(std::string_view name) {
+        if (name.size() != 32) { return Empty; }
+        u128 key = 0;
+        for (const char c : name) {
+            const size_t digit = kHexDigits.find(c);
+            if (digit == std::string_view::npos) { return Empty; }
+            key = (key << 4) | digit;
+        }
+        return key;
+    }
+
+    // Bumps the modification time, which is what Scan() orders artifacts by after a restart
+    static void TouchFile(const str& path) {
+#ifdef _WIN32
+        _utime(path.c_str(), None);
+#else
+        utimensat(AT_FDCWD, path.c_str(), None, 0);
+#endif
+    }
+
+    ContentCache::ContentCache(const str& root, const u64 maxBytes)
+        : _root(root), _maxBytes(maxBytes) {
+        _valid = Path(_root).CreateAll();
+        if (_valid) { Scan(); }
+    }
+
+    u128 ContentCache::MakeKey(std::span<const std::span<const u8>> inputs) {
+        // Chaining the input hashes through the seed keeps the boundaries between inputs
+        u128 key = Hash128(std::span<const u8> {}, inputs.size());
+        for (const auto& input : inputs) {
+            key = Hash128(input, CAST<u64>(key) ^ CAST<u64>(key >> 64));
+        }
+        return key;
+    }
+
+    str ContentCache::KeyToHex(u128 key) {
+        str hex(32, '0');
+        for (size_t i = 32; i-- > 0; key >>= 4) {
+            hex[i] = kHexDigits[CAST<size_t>(key & 0xF)];
+        }
+        return hex;
+    }
+
+    bool ContentCache::IsValid() const {
+        return _valid;
+    }
+
+    bool ContentCache::Contains(const u128 key) const {
+        std::lock_guard lock(_mutex);
+        return _index.contains(key);
+    }
+
+    MappedFile ContentCache::Load(const u128 key) {
+        const str path = PathFor(key);
+        MappedFile file(path);
+        {
+            std::lock_guard lock(_mutex);
+            if (!file.IsOpen()) {
+                _misses++;
+                RemoveLocked(key);  // Deleted behind our back
+                return file;
+            }
+            _hits++;
+            MarkUsedLocked(key, file.Size());
+        }
+        TouchFile(path);
+        return file;
+    }
+
+    FsResult<void> ContentCache::Store(const u128 key, std::span<const u8> data) {
+        const str path = PathFor(key);
+        const Path shard(path.substr(0, path.size() - 33));
+        if (!shard.Create()) { return Unexpected(FsError {errno}); }
+
+        // Atomic, so a reader mapping the previous artifact keeps seeing it intact
+        if (auto result = FileWriter::TryWriteAllBytes(path, {&data, 1}, WriteMode::Atomic);
+            !result) {
+            return result;
+        }
+
+        std::lock_guard lock(_mutex);
+        _stores++;
+        RemoveLocked(key);
+        MarkUsedLocked(key, data.size());
+        EvictLocked();
+        return {};
+    }
+
+    void ContentCache::Remove(const u128 key) {
+        std::remove(PathFor(key).c_str());
+        std::lock_guard lock(_mutex);
+        RemoveLocked(key);
+    }
+
+    ContentCacheStats ContentCache::GetStats() const {
+        std::lock_guard lock(_mutex);
+        ContentCacheStats stats {};
+        stats.hits      = _hits;
+        stats.misses    = _misses;
+        stats.stores    = _stores;
+        stats.evictions = _evictions;
+        stats.bytes     = _bytes;
+        stats.entries   = _index.size();
+        return stats;
+    }
+
+    str ContentCache::PathFor(const u128 key) const {
+        const str hex = KeyToHex(key);
+        return _root + '/' + hex.substr(0, 2) + '/' + hex;
+    }
+
+    void ContentCache::Scan() {
+        struct Found {
+            Entry entry;
+            i64 mtimeNs;
+        };
+        vector<Found> found;
+
+        const i64 now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+        for (const PathId id : Directory::Walk(_root)) {
+            const std::string_view path = id.Str();
+            const std::string_view name = path.substr(path.find_last_of('/') + 1);
+            const auto metadata         = Path(str(path)).Stat();
+            if (!metadata) { continue; }
+
+            if (const auto key = ParseKey(name)) {
+                found.push_back({{*key, metadata->size}, metadata->mtimeNs});
+            } else if (name.ends_with(".tmp") && now - metadata->mtimeNs > kStaleTempNs) {
+                std::remove(str(path).c_str());
+            }
+        }
+
+        std::ranges::sort(found, std::ranges::greater {}, &Found::mtimeNs);
+        std::lock_guard lock(_mutex);
+        for (const auto& [entry, _] : found) {
+            _lru.push_back(entry);
+            _index[entry.key] = std::prev(_lru.end());
+            _bytes += entry.size;
+        }
+        EvictLocked();
+    }
+
+    void ContentCache::MarkUsedLocked(const u128 key, const u64 size) {
+        if (const auto it = _index.find(key); it != _index.end()) {
+            _lru.splice(_lru.begin(), _lru, it->second);
+            return;
+        }
+        _lru.push_front({key, size});
+        _index[key] = _lru.begin();
+        _bytes += size;
+    }
+
+    void ContentCache::RemoveLocked(const u128 key) {
+        const auto it = _index.find(key);
+        if (it == _index.end()) { return; }
+        _bytes -= it->second->size;
+        _lru.erase(it->second);
+        _index.erase(it);
+    }
+
+    void ContentCache::EvictLocked() {
+        while (_bytes > _maxBytes && _lru.size() > 1) {
+            const Entry& victim = _lru.back();
+            std::remove(PathFor(victim.key).c_str());
+            _bytes -= victim.size;
+            _index.erase(victim.key);
+            _lru.pop_back();
+            _evictions++;
+        }
+    }
+}  // namespace x::Filesystem
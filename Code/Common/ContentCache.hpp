@@ -0,0 +1,128 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Filesystem.hpp"
+
+#include <list>
+#include <mutex>
+
+namespace x::Filesystem {
+    struct ContentCacheStats {
+        u64 hits;
+        u64 misses;
+        u64 stores;
+        u64 evictions;
+        u64 bytes;  // Total size of the cached artifacts
+        size_t entries;
+    };
+
+    /// An artifact handed out by ContentCache::GetOrBuild(): the cached file mapped, or the bytes
+    /// that were just built when they couldn't be stored (or were evicted before being mapped).
+    class ContentArtifact {
+    public:
+        ContentArtifact() = default;
+        explicit ContentArtifact(MappedFile file) : _file(std::move(file)) {}
+        explicit ContentArtifact(std::vector<u8> built) : _built(std::move(built)) {}
+
+        /// False when the artifact only lives in memory and will be rebuilt next time.
+        [[nodiscard]] bool IsCached() const {
+            return _file.IsOpen();
+        }
+        [[nodiscard]] std::span<const u8> Data() const {
+            return _file.IsOpen() ? _file.Data() : std::span<const u8>(_built);
+        }
+
+    private:
+        MappedFile _file;
+        std::vector<u8> _built;
+    };
+
+    /// On-disk cache of derived artifacts (compiled SPIR-V, pipeline cache blobs, cooked assets)
+    /// addressed by a 128-bit hash of everything that went into building them. Artifacts live
+    /// in `root`, sharded into 256 subdirectories by the first byte of their key, and are
+    /// stored atomically so a crash never leaves a torn artifact behind. Hits are mmap'd.
+    ///
+    /// The total size is capped: storing past the cap evicts the least recently used artifacts.
+    /// Recency survives restarts through file modification times. The index is per-process, so
+    /// two processes sharing a root may evict each other's artifacts but never corrupt them.
+    class ContentCache {
+    public:
+        static constexpr u64 kDefaultMaxBytes = 1ULL << 30;
+
+        explicit ContentCache(const str& root, u64 maxBytes = kDefaultMaxBytes);
+
+        ContentCache(const ContentCache&)            = delete;
+        ContentCache& operator=(const ContentCache&) = delete;
+
+        /// Key of an artifact built from `inputs`, e.g. the source, the defines and the compiler
+        /// version. Order matters and buffer boundaries count, so {"ab", "c"} != {"a", "bc"}.
+        static u128 MakeKey(std::span<const std::span<const u8>> inputs);
+        /// Lowercase hex spelling of `key`, as used for the artifact's file name.
+        static str KeyToHex(u128 key);
+
+        [[nodiscard]] bool IsValid() const;
+        [[nodiscard]] bool Contains(u128 key) const;
+
+        /// Maps the artifact for `key`. The returned file isn't open on a miss.
+        MappedFile Load(u128 key);
+        /// Stores `data` as the artifact for `key`, replacing any previous one.
+        FsResult<void> Store(u128 key, std::span<const u8> data);
+        void Remove(u128 key);
+
+        /// Loads the artifact for `key`, or runs `build` (returning std::vector<u8>) and stores
+        /// its result. If the store fails, or another Store() evicts it before it's mapped, the
+        /// built bytes are returned from memory instead and the artifact is rebuilt next time.
+        template<typename Build>
+        ContentArtifact GetOrBuild(u128 key, Build&& build) {
+            if (MappedFile file = Load(key); file.IsOpen()) {
+                return ContentArtifact(std::move(file));
+            }
+            std::vector<u8> data = build();
+            if (Store(key, data)) {
+                if (MappedFile file(PathFor(key)); file.IsOpen()) {
+                    return ContentArtifact(std::move(file));
+                }
+            }
+            return ContentArtifact(std::move(data));
+        }
+
+        [[nodiscard]] ContentCacheStats GetStats() const;
+
+    private:
+        struct Entry {
+            u128 key;
+            u64 size;
+        };
+
+        struct KeyHash {
+            size_t operator()(const u128 key) const noexcept {
+                return CAST<size_t>(CAST<u64>(key) ^ CAST<u64>(key >> 64));
+            }
+        };
+
+        [[nodiscard]] str PathFor(u128 key) const;
+        void Scan();
+        // Moves `key` to the front of the LRU list, adding it if another process stored it
+        void MarkUsedLocked(u128 key, u64 size);
+        void RemoveLocked(u128 key);
+        // Drops least recently used artifacts until the cache fits, except the most recent one
+        void EvictLocked();
+
+        str _root;
+        u64 _maxBytes;
+        bool _valid = false;
+
+        mutable std::mutex _mutex;
+        std::list<Entry> _lru;  // Most recently used first
+        unordered_map<u128, std::list<Entry>::iterator, KeyHash> _index;
+        u64 _bytes = 0;
+
+        u64 _hits      = 0;
+        u64 _misses    = 0;
+        u64 _stores    = 0;
+        u64 _evictions = 0;
+    };
+}  // namespace x::Filesystem
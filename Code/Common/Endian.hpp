@@ -0,0 +1,45 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Types.hpp"
+
+#include <bit>
+#include <type_traits>
+
+namespace x {
+    template<typename T>
+    concept Trivial = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+    template<Trivial T>
+    constexpr T ByteSwap(T value) {
+        if constexpr (sizeof(T) == 1) {
+            return value;
+        } else {
+            using Bits = std::conditional_t<sizeof(T) == 2,
+                                            u16,
+                                            std::conditional_t<sizeof(T) == 4, u32, u64>>;
+
+            auto bits = std::bit_cast<Bits>(value);
+            Bits swapped {};
+            for (size_t i = 0; i < sizeof(T); i++) {
+                swapped = CAST<Bits>((swapped << 8) | (bits & 0xFF));
+                bits    = CAST<Bits>(bits >> 8);
+            }
+            return std::bit_cast<T>(swapped);
+        }
+    }
+
+    /// Converts between native and little-endian byte order, which is what every on-disk format
+    /// in the engine uses. A no-op on little-endian hosts.
+    template<Trivial T>
+    constexpr T LittleEndian(T value) {
+        if constexpr (std::endian::native == std::endian::little) {
+            return value;
+        } else {
+            return ByteSwap(value);
+        }
+    }
+}  // namespace x
@@ -0,0 +1,293 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#include "FileWatcher.hpp"
+#include "Queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <iterator>
+#include <mutex>
+
+#ifdef __linux__
+    #include <dirent.h>
+    #include <poll.h>
+    #include <sys/eventfd.h>
+    #include <sys/inotify.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace x::Filesystem {
+#ifdef __linux__
+    static constexpr u32 kDirMask = IN_CREATE | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM |
+                                    IN_MOVED_TO | IN_ONLYDIR | IN_EXCL_UNLINK;
+
+    // Batches the watcher thread can get ahead of Poll() by. When it's full the thread holds on
+    // to its pending changes and keeps coalescing into them.
+    static constexpr size_t kBatchSlots = 16;
+
+    struct FileWatcher::State {
+        int inotifyFd = -1;
+        int wakeFd    = -1;
+        std::chrono::milliseconds debounce;
+        std::atomic<bool> running {true};
+
+        // Watch descriptor to directory path. Watch() adds to it from the caller's thread.
+        std::mutex watchMutex;
+        unordered_map<i32, str> watches;
+        vector<str> roots;
+
+        // Change batches from the watcher thread (producer) to Poll() (consumer)
+        SpscQueue<vector<FileChange>> batches {kBatchSlots};
+
+        // Only touched by the watcher thread
+        unordered_map<str, FileChange::Kind> pending;
+        std::chrono::steady_clock::time_point lastEvent;
+
+        void Merge(const str& path, FileChange::Kind kind) {
+            using Kind          = FileChange::Kind;
+            lastEvent           = std::chrono::steady_clock::now();
+            auto [it, inserted] = pending.try_emplace(path, kind);
+            if (inserted) { return; }
+
+            Kind& previous = it->second;
+            if (previous == Kind::Overflow) { return; }
+            switch (kind) {
+                case Kind::Created:
+                    // Deleted and recreated, e.g. an editor saving through a temp file
+                    previous = previous == Kind::Removed ? Kind::Modified : Kind::Created;
+                    break;
+                case Kind::Modified:
+                    if (previous != Kind::Created) { previous = Kind::Modified; }
+                    break;
+                case Kind::Removed:
+                    if (previous == Kind::Created) {
+                        pending.erase(it);
+                    } else {
+                        previous = Kind::Removed;
+                    }
+                    break;
+                case Kind::Overflow:
+                    previous = Kind::Overflow;
+                    break;
+            }
+        }
+
+        // Adds a watch for `dir` and every directory below it. Directories that appear while the
+        // watcher runs may already contain files written before their watch existed, so the
+        // watcher thread reports those as created. Watch() passes false and never touches
+        // `pending`, which belongs to the watcher thread.
+        bool AddTree(const str& dir, const bool reportFiles) {
+            const i32 wd = inotify_add_watch(inotifyFd, dir.c_str(), kDirMask);
+            if (wd < 0) { return false; }
+            {
+                std::lock_guard lock(watchMutex);
+                watches[wd] = dir;
+            }
+
+            DIR* handle = opendir(dir.c_str());
+            if (!handle) { return true; }
+            while (const dirent* entry = readdir(handle)) {
+                const std::string_view name = entry->d_name;
+                if (name == "." || name == "..") { continue; }
+
+                const str path = dir + '/' + entry->d_name;
+                bool isDir     = entry->d_type == DT_DIR;
+                if (entry->d_type == DT_UNKNOWN) {
+                    // Some filesystems don't fill in d_type
+                    struct stat info {};
+                    isDir = lstat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+                }
+
+                if (isDir) {
+                    AddTree(path, reportFiles);
+                } else if (reportFiles) {
+                    Merge(path, FileChange::Kind::Created);
+                }
+            }
+            closedir(handle);
+            return true;
+        }
+
+        // Stops watching `dir` and everything below it after it was moved out of the tree
+        void RemoveTree(const str& dir) {
+            std::lock_guard lock(watchMutex);
+            for (auto it = watches.begin(); it != watches.end();) {
+                const str& path = it->second;
+                if (path == dir || (path.starts_with(dir) && path[dir.size()] == '/')) {
+                    inotify_rm_watch(inotifyFd, it->first);
+                    it = watches.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        void HandleEvent(const inotify_event& event) {
+            using Kind = FileChange::Kind;
+
+            if (event.mask & IN_Q_OVERFLOW) {
+                // Events were dropped, the best we can do is tell the caller to reload everything
+                std::lock_guard lock(watchMutex);
+                for (const str& root : roots) {
+                    Merge(root, Kind::Overflow);
+                }
+                return;
+            }
+
+            str dir;
+            {
+                std::lock_guard lock(watchMutex);
+                const auto it = watches.find(event.wd);
+                if (it == watches.end()) { return; }
+                if (event.mask & IN_IGNORED) {
+                    watches.erase(it);
+                    return;
+                }
+                dir = it->second;
+            }
+            if (event.len == 0) { return; }
+
+            const str path = dir + '/' + event.name;
+            if (event.mask & IN_ISDIR) {
+                if (event.mask & (IN_CREATE | IN_MOVED_TO)) { AddTree(path, true); }
+                if (event.mask & IN_MOVED_FROM) { RemoveTree(path); }
+                return;
+            }
+
+            if (event.mask & (IN_CREATE | IN_MOVED_TO)) { Merge(path, Kind::Created); }
+            if (event.mask & IN_CLOSE_WRITE) { Merge(path, Kind::Modified); }
+            if (event.mask & (IN_DELETE | IN_MOVED_FROM)) { Merge(path, Kind::Removed); }
+        }
+
+        // Hands the pending changes to Poll(), returns false if the queue is full
+        bool Publish() {
+            // Only Poll() frees slots, so from this side a queue that has room keeps it and the
+            // batch is only built once it can be pushed
+            if (batches.SizeApprox() >= batches.Capacity()) { return false; }
+
+            vector<FileChange> batch;
+            batch.reserve(pending.size());
+            for (auto& [path, kind] : pending) {
+                batch.push_back({path, kind});
+            }
+            std::ranges::sort(batch, {}, &FileChange::path);
+            batches.TryPush(std::move(batch));
+            pending.clear();
+            return true;
+        }
+    };
+
+    FileWatcher::FileWatcher(const u32 debounceMs) : _state(make_unique<State>()) {
+        _state->debounce  = std::chrono::milliseconds(debounceMs);
+        _state->inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        _state->wakeFd    = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (!IsValid()) { return; }
+
+        _thread = std::thread(&FileWatcher::WatchLoop, this);
+    }
+
+    FileWatcher::~FileWatcher() {
+        if (_thread.joinable()) {
+            _state->running.store(false);
+            const u64 wake = 1;
+            [[maybe_unused]] const auto written = write(_state->wakeFd, &wake, sizeof(wake));
+            _thread.join();
+        }
+        if (_state->inotifyFd >= 0) { close(_state->inotifyFd); }
+        if (_state->wakeFd >= 0) { close(_state->wakeFd); }
+    }
+
+    bool FileWatcher::IsValid() const {
+        return _state->inotifyFd >= 0 && _state->wakeFd >= 0;
+    }
+
+    bool FileWatcher::Watch(const str& root) {
+        if (!IsValid()) { return false; }
+
+        str dir = root;
+        while (dir.size() > 1 && dir.back() == '/') {
+            dir.pop_back();
+        }
+
+        if (!_state->AddTree(dir, false)) { return false; }
+
+        std::lock_guard lock(_state->watchMutex);
+        _state->roots.push_back(std::move(dir));
+        return true;
+    }
+
+    bool FileWatcher::Poll(std::vector<FileChange>& changes) {
+        bool changed = false;
+        vector<FileChange> batch;
+        while (_state->batches.TryPop(batch)) {
+            std::ranges::move(batch, std::back_inserter(changes));
+            changed = true;
+        }
+        return changed;
+    }
+
+    void FileWatcher::WatchLoop() {
+        using namespace std::chrono;
+
+        // Large enough for a burst of events, each one is at most sizeof(inotify_event) + NAME_MAX
+        alignas(inotify_event) char buffer[64 * 1024];
+        pollfd fds[2] = {{_state->inotifyFd, POLLIN, 0}, {_state->wakeFd, POLLIN, 0}};
+
+        while (_state->running.load(std::memory_order_relaxed)) {
+            // Sleep until something happens, or until the pending changes have been quiet for
+            // the debounce interval
+            int timeout = -1;
+            if (!_state->pending.empty()) {
+                const auto quiet = steady_clock::now() - _state->lastEvent;
+                const auto left  = duration_cast<milliseconds>(_state->debounce - quiet);
+                timeout          = CAST<int>(std::max<i64>(left.count(), 0));
+            }
+
+            if (poll(fds, 2, timeout) < 0 && errno != EINTR) { break; }
+
+            if (fds[0].revents & POLLIN) {
+                ssize_t length;
+                while ((length = read(_state->inotifyFd, buffer, sizeof(buffer))) > 0) {
+                    for (ssize_t offset = 0; offset < length;) {
+                        const auto* event = RCAST<const inotify_event*>(buffer + offset);
+                        _state->HandleEvent(*event);
+                        offset += CAST<ssize_t>(sizeof(inotify_event) + event->len);
+                    }
+                }
+            }
+
+            if (!_state->pending.empty() &&
+                steady_clock::now() - _state->lastEvent >= _state->debounce) {
+                // If Poll() has fallen behind, keep coalescing and try again after another
+                // debounce interval
+                if (!_state->Publish()) { _state->lastEvent = steady_clock::now(); }
+            }
+        }
+    }
+#else
+    struct FileWatcher::State {};
+
+    FileWatcher::FileWatcher(u32) : _state(make_unique<State>()) {}
+
+    FileWatcher::~FileWatcher() = default;
+
+    bool FileWatcher::IsValid() const {
+        return false;
+    }
+
+    bool FileWatcher::Watch(const str&) {
+        return false;
+    }
+
+    bool FileWatcher::Poll(std::vector<FileChange>&) {
+        return false;
+    }
+
+    void FileWatcher::WatchLoop() {}
+#endif
+}  // namespace x::Filesystem
@@ -0,0 +1,59 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Types.hpp"
+
+#include <thread>
+#include <vector>
+
+namespace x::Filesystem {
+    struct FileChange {
+        enum class Kind : u8 {
+            Created,
+            Modified,
+            Removed,
+            Overflow,  // Events were dropped, anything below the watch root in `path` may differ
+        };
+
+        str path;  // Watch root joined with the path below it, e.g. "Shaders/Unlit.vert.spv"
+        Kind kind;
+    };
+
+    /// Watches directory trees with inotify on a background thread. Events are coalesced per path
+    /// and only handed over once the tree has been quiet for the debounce interval, so a save or
+    /// a shader compile arrives as a single batch. Poll() is one atomic load when nothing changed
+    /// and never touches the filesystem, so it's meant to be called once per frame.
+    ///
+    /// Events dropped by an inotify queue overflow are reported as an Overflow change of each
+    /// watch root. Only implemented on Linux, elsewhere Watch() fails.
+    class FileWatcher {
+    public:
+        static constexpr u32 kDefaultDebounceMs = 100;
+
+        explicit FileWatcher(u32 debounceMs = kDefaultDebounceMs);
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher&)            = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        [[nodiscard]] bool IsValid() const;
+
+        /// Watches `root` and every directory below it, including directories created later.
+        bool Watch(const str& root);
+
+        /// Appends the changes delivered since the last call to `changes`, returns false if there
+        /// were none. Must only be called from one thread.
+        bool Poll(std::vector<FileChange>& changes);
+
+    private:
+        struct State;
+
+        void WatchLoop();
+
+        unique_ptr<State> _state;
+        std::thread _thread;
+    };
+}  // namespace x::Filesystem
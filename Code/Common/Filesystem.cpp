@@ -3,8 +3,12 @@
 //
 
 #include "Filesystem.hpp"
+#include "Hash.hpp"
 #include "Panic.inl"
 
+#include <cerrno>
+#include <condition_variable>
+#include <shared_mutex>
 #include <sstream>
 
 #ifdef _WIN32
@@ -25,133 +29,1635 @@
     #endif
 #else
     #include <sys/stat.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <sys/uio.h>
+    #include <dirent.h>
+    #include <fcntl.h>
 #endif
 
 namespace x::Filesystem {
 #pragma region FileReader
+    // The errno of the call that just failed
+    static Unexpected<FsError> LastError() {
+        return Unexpected(FsError {errno});
+    }
+
+    static FsResult<FileMetadata> StatPath(const char* path) {
+        struct stat info {};
+        if (stat(path, &info) != 0) { return LastError(); }
+
+        FileMetadata metadata;
+        metadata.type = S_ISREG(info.st_mode)   ? FileMetadata::Type::File
+                        : S_ISDIR(info.st_mode) ? FileMetadata::Type::Directory
+                                                : FileMetadata::Type::Other;
+        metadata.size = CAST<u64>(info.st_size);
+#ifdef _WIN32
+        metadata.mtimeNs = CAST<i64>(info.st_mtime) * 1'000'000'000;
+#else
+        metadata.mtimeNs = CAST<i64>(info.st_mtim.tv_sec) * 1'000'000'000 + info.st_mtim.tv_nsec;
+#endif
+        return metadata;
+    }
+
+    static struct {
+        std::atomic<u64> requested {0};
+        std::atomic<u64> dropped {0};
+        std::atomic<u64> completed {0};
+        std::atomic<u64> failed {0};
+        std::atomic<u64> bytes {0};
+        std::atomic<u64> evicted {0};
+        std::atomic<u64> readBlockCalls {0};
+        std::atomic<u64> readBlockNs {0};
+    } gPrefetch;
+
+    // Adds the lifetime of a ReadBlock call to the prefetch stats
+    class ReadBlockTimer {
+    public:
+        ReadBlockTimer() : _start(std::chrono::steady_clock::now()) {}
+
+        ~ReadBlockTimer() {
+            const auto elapsed = std::chrono::steady_clock::now() - _start;
+            gPrefetch.readBlockCalls.fetch_add(1, std::memory_order_relaxed);
+            gPrefetch.readBlockNs.fetch_add(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+              std::memory_order_relaxed);
+        }
+
+    private:
+        std::chrono::steady_clock::time_point _start;
+    };
+
     std::vector<u8> FileReader::ReadAllBytes(const str& path) {
-        std::ifstream file(path, std::ios::binary | std::ios::ate);
-        if (!file.is_open()) { return {}; }
-        const std::streamsize fileSize = file.tellg();
-        std::vector<u8> bytes(fileSize);
-        file.seekg(0, std::ios::beg);
-        if (!file.read(reinterpret_cast<char*>(bytes.data()), fileSize)) { return {}; }
-        file.close();
-        return bytes;
+        return TryReadAllBytes(path).ValueOr(std::vector<u8> {});
     }
 
     str FileReader::ReadAllText(const str& path) {
-        const std::ifstream file(path);
-        if (!file.is_open()) { return {}; }
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        return buffer.str();
+        return TryReadAllText(path).ValueOr(str {});
     }
 
     std::vector<str> FileReader::ReadAllLines(const str& path) {
-        std::ifstream file(path);
         std::vector<str> lines;
-        if (!file.is_open()) { return {}; }
-        str line;
-        while (std::getline(file, line)) {
-            lines.push_back(line);
+        for (const auto line : FileLines(path)) {
+            lines.emplace_back(line);
         }
         return lines;
     }
 
     std::vector<u8> FileReader::ReadBlock(const str& path, size_t size, u64 offset) {
-        std::ifstream file(path, std::ios::binary | std::ios::ate);
-        if (!file) { return {}; }
-        const std::streamsize fileSize = file.tellg();
-        if (offset >= (u64)fileSize || size == 0 || offset + size > (u64)fileSize) { return {}; }
-        file.seekg((std::streamsize)offset, std::ios::beg);
-        if (!file) { return {}; }
+        return TryReadBlock(path, size, offset).ValueOr(std::vector<u8> {});
+    }
+
+    FsResult<std::vector<u8>> FileReader::TryReadAllBytes(const str& path) {
+        std::vector<u8> bytes;
+        if (auto result = ReadAllBytes(path, bytes); !result) { return Unexpected(result.Error()); }
+        return bytes;
+    }
+
+    FsResult<str> FileReader::TryReadAllText(const str& path) {
+        str text;
+        if (auto result = ReadAllText(path, text); !result) { return Unexpected(result.Error()); }
+        return text;
+    }
+
+    FsResult<std::vector<u8>>
+    FileReader::TryReadBlock(const str& path, const size_t size, const u64 offset) {
+        const auto fileSize = TryQueryFileSize(path);
+        if (!fileSize) { return Unexpected(fileSize.Error()); }
+        if (offset > *fileSize || size > *fileSize - offset) {
+            return Unexpected(FsError {EINVAL});
+        }
+
         std::vector<u8> buffer(size);
-        file.read(reinterpret_cast<char*>(buffer.data()), (std::streamsize)size);
-        if (!file) { return {}; }
+        const auto read = ReadBlock(path, std::span(buffer), offset);
+        if (!read) { return Unexpected(read.Error()); }
+        if (*read != size) { return Unexpected(FsError {EIO}); }  // Truncated in the meantime
         return buffer;
     }
 
-    size_t FileReader::QueryFileSize(const str& path) {
+    FsResult<size_t> FileReader::TryQueryFileSize(const str& path) {
+        const auto metadata = StatPath(path.c_str());
+        if (!metadata) { return Unexpected(metadata.Error()); }
+        if (metadata->type == FileMetadata::Type::Directory) {
+            return Unexpected(FsError {EISDIR});
+        }
+        return CAST<size_t>(metadata->size);
+    }
+
+    FsResult<size_t> FileReader::ReadBlock(const str& path, std::span<u8> dest, const u64 offset) {
+        const ReadBlockTimer timer;
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary);
+        if (!file) { return Unexpected(FsError {ENOENT}); }
+        file.seekg(CAST<std::streamoff>(offset), std::ios::beg);
+        file.read(RCAST<char*>(dest.data()), CAST<std::streamsize>(dest.size()));
+        if (file.bad()) { return Unexpected(FsError {EIO}); }
+        return CAST<size_t>(file.gcount());
+#else
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) { return LastError(); }
+
+        size_t total = 0;
+        while (total < dest.size()) {
+            const ssize_t result =
+              pread(fd, dest.data() + total, dest.size() - total, CAST<off_t>(offset + total));
+            if (result < 0 && errno == EINTR) { continue; }
+            if (result < 0) {
+                const int error = errno;
+                close(fd);
+                return Unexpected(FsError {error});
+            }
+            if (result == 0) { break; }
+            total += CAST<size_t>(result);
+        }
+        close(fd);
+        return total;
+#endif
+    }
+
+    template<typename Container>
+    static FsResult<size_t> ReadWholeFile(const str& path, Container& out) {
+#ifdef _WIN32
         std::ifstream file(path, std::ios::binary | std::ios::ate);
-        if (!file.is_open()) { return 0; }
-        const std::streamsize fileSize = file.tellg();
-        return fileSize;
+        if (!file) { return Unexpected(FsError {ENOENT}); }
+        out.resize(CAST<size_t>(file.tellg()));
+        file.seekg(0, std::ios::beg);
+        file.read(RCAST<char*>(out.data()), CAST<std::streamsize>(out.size()));
+        if (!file) { return Unexpected(FsError {EIO}); }
+        return out.size();
+#else
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) { return LastError(); }
+
+        struct stat info {};
+        if (fstat(fd, &info) != 0) {
+            const int error = errno;
+            close(fd);
+            return Unexpected(FsError {error});
+        }
+        if (S_ISDIR(info.st_mode)) {
+            close(fd);
+            return Unexpected(FsError {EISDIR});
+        }
+        if (info.st_size == 0) {
+            // Pipes and files in /proc or /sys report a size of 0, read those until EOF instead
+            static constexpr size_t kReadChunk = 4096;
+            size_t total = 0;
+            for (;;) {
+                out.resize(total + kReadChunk);
+                const ssize_t result = read(fd, RCAST<u8*>(out.data()) + total, kReadChunk);
+                if (result < 0 && errno == EINTR) { continue; }
+                if (result < 0) {
+                    const int error = errno;
+                    close(fd);
+                    return Unexpected(FsError {error});
+                }
+                if (result == 0) { break; }
+                total += CAST<size_t>(result);
+            }
+            close(fd);
+            out.resize(total);
+            return total;
+        }
+        // resize() keeps the capacity, so this only allocates when the file outgrew `out`
+        out.resize(CAST<size_t>(info.st_size));
+
+        size_t total = 0;
+        while (total < out.size()) {
+            const ssize_t result = pread(fd,
+                                         RCAST<u8*>(out.data()) + total,
+                                         out.size() - total,
+                                         CAST<off_t>(total));
+            if (result < 0 && errno == EINTR) { continue; }
+            if (result <= 0) {
+                const int error = result < 0 ? errno : EIO;  // Truncated while we read it
+                close(fd);
+                return Unexpected(FsError {error});
+            }
+            total += CAST<size_t>(result);
+        }
+        close(fd);
+        return total;
+#endif
+    }
+
+    FsResult<size_t> FileReader::ReadAllBytes(const str& path, std::vector<u8>& out) {
+        return ReadWholeFile(path, out);
+    }
+
+    FsResult<size_t> FileReader::ReadAllText(const str& path, str& out) {
+        if (auto result = ReadWholeFile(path, out); !result) { return result; }
+        // Only files that start with a BOM pay for shifting the text down
+        if (out.starts_with(kUtf8Bom)) { out.erase(0, kUtf8Bom.size()); }
+        return out.size();
+    }
+
+    FsResult<MappedText> FileReader::MapAllText(const str& path) {
+        MappedFile file;
+        errno = 0;
+        if (!file.Open(path, MappedFile::AccessHint::Sequential)) {
+            return Unexpected(FsError {errno != 0 ? errno : EIO});
+        }
+        return MappedText(std::move(file));
+    }
+
+#ifndef _WIN32
+    // Runs preadv/pwritev (`transfer`) over the whole span list starting at `offset`, resuming
+    // after short transfers, and returns the number of bytes moved. Lists longer than the iovec
+    // batch take one syscall per batch.
+    template<typename Byte, typename Transfer>
+    static size_t TransferVectored(const int fd,
+                                   std::span<const std::span<Byte>> buffers,
+                                   const u64 offset,
+                                   Transfer&& transfer) {
+        static constexpr size_t kMaxIovecs = 64;
+
+        size_t total = 0;
+        size_t index = 0;  // First buffer that isn't done yet
+        size_t done  = 0;  // Bytes of buffers[index] already transferred
+        while (index < buffers.size()) {
+            iovec iovecs[kMaxIovecs];
+            int count = 0;
+            for (size_t i = index; i < buffers.size() && count < CAST<int>(kMaxIovecs); i++) {
+                const size_t skip = i == index ? done : 0;
+                if (buffers[i].size() == skip) { continue; }
+                iovecs[count++] = {CCAST<u8*>(buffers[i].data()) + skip, buffers[i].size() - skip};
+            }
+            if (count == 0) { break; }
+
+            const ssize_t result = transfer(fd, iovecs, count, CAST<off_t>(offset + total));
+            if (result < 0 && errno == EINTR) { continue; }
+            if (result == 0) { errno = EIO; }  // No progress, so callers can still report errno
+            if (result <= 0) { break; }
+
+            total += CAST<size_t>(result);
+            for (size_t moved = CAST<size_t>(result); index < buffers.size();) {
+                const size_t left = buffers[index].size() - done;
+                if (moved < left) {
+                    done += moved;
+                    break;
+                }
+                moved -= left;
+                done = 0;
+                index++;
+            }
+        }
+        return total;
+    }
+
+    static bool WriteVectored(const int fd,
+                              std::span<const std::span<const u8>> buffers,
+                              const u64 offset) {
+        size_t expected = 0;
+        for (const auto& buffer : buffers) {
+            expected += buffer.size();
+        }
+        return TransferVectored(fd, buffers, offset, pwritev) == expected;
+    }
+
+    // Closes `fd` once a write finished, keeping the errno of whichever of the two failed first.
+    // close() can report a failed delayed write on some filesystems.
+    static FsResult<void> CloseAfterWrite(const int fd, const bool written) {
+        const int error = written ? 0 : errno;
+        if (close(fd) != 0 && written) { return LastError(); }
+        if (!written) { return Unexpected(FsError {error}); }
+        return {};
+    }
+#endif
+
+    bool FileReader::ReadBlock(const str& path,
+                               std::span<const std::span<u8>> buffers,
+                               const u64 offset) {
+        const ReadBlockTimer timer;
+        size_t expected = 0;
+        for (const auto& buffer : buffers) {
+            expected += buffer.size();
+        }
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary);
+        if (!file) { return false; }
+        file.seekg(CAST<std::streamoff>(offset), std::ios::beg);
+        for (const auto& buffer : buffers) {
+            file.read(RCAST<char*>(buffer.data()), CAST<std::streamsize>(buffer.size()));
+            if (!file) { return false; }
+        }
+        return true;
+#else
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) { return false; }
+        const size_t read = TransferVectored(fd, buffers, offset, preadv);
+        close(fd);
+        return read == expected;
+#endif
+    }
+
+    bool FileReader::ReadBlocks(std::span<ReadRequest> requests) {
+        bool ok = true;
+#ifdef _WIN32
+        for (auto& request : requests) {
+            request.bytesRead = 0;
+            request.error     = 0;
+            std::ifstream file(request.path, std::ios::binary);
+            if (!file) {
+                request.error = ENOENT;
+                ok            = false;
+                continue;
+            }
+            file.seekg(CAST<std::streamoff>(request.offset), std::ios::beg);
+            file.read(RCAST<char*>(request.buffer.data()),
+                      CAST<std::streamsize>(request.buffer.size()));
+            request.bytesRead = CAST<size_t>(file.gcount());
+            if (request.bytesRead != request.buffer.size()) {
+                request.error = EIO;
+                ok            = false;
+            }
+        }
+#else
+        // Requests commonly hit the same archive many times, so only open each path once
+        unordered_map<str, int> openFiles;
+        for (auto& request : requests) {
+            request.bytesRead = 0;
+            request.error     = 0;
+
+            auto it = openFiles.find(request.path);
+            if (it == openFiles.end()) {
+                const int fd = open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+                it           = openFiles.emplace(request.path, fd >= 0 ? fd : -errno).first;
+            }
+            if (it->second < 0) {
+                request.error = -it->second;
+                ok            = false;
+                continue;
+            }
+
+            while (request.bytesRead < request.buffer.size()) {
+                const ssize_t result = pread(it->second,
+                                             request.buffer.data() + request.bytesRead,
+                                             request.buffer.size() - request.bytesRead,
+                                             CAST<off_t>(request.offset + request.bytesRead));
+                if (result < 0 && errno == EINTR) { continue; }
+                if (result <= 0) {
+                    request.error = result < 0 ? errno : EIO;  // 0 means we hit EOF early
+                    ok            = false;
+                    break;
+                }
+                request.bytesRead += CAST<size_t>(result);
+            }
+        }
+        for (const auto& [_, fd] : openFiles) {
+            if (fd >= 0) { close(fd); }
+        }
+#endif
+        return ok;
+    }
+
+    size_t FileReader::QueryFileSize(const str& path) {
+        return TryQueryFileSize(path).ValueOr(0);
+    }
+
+#ifdef __linux__
+    static constexpr size_t kReadaheadChunk = 256 * 1024;
+#endif
+
+    // Applies WILLNEED or DONTNEED to every range, opening each run of ranges on the same file
+    // once. Runs on an IoPool worker.
+    static void ApplyCacheHints(const std::vector<PrefetchRange>& ranges, const bool willNeed) {
+#ifdef __linux__
+        int fd              = -1;
+        const str* openPath = None;
+        for (const auto& range : ranges) {
+            if (!openPath || *openPath != range.path) {
+                if (fd >= 0) { close(fd); }
+                fd       = open(range.path.c_str(), O_RDONLY | O_CLOEXEC);
+                openPath = &range.path;
+            }
+            if (fd < 0) {
+                if (willNeed) { gPrefetch.failed.fetch_add(1, std::memory_order_relaxed); }
+                continue;
+            }
+
+            if (!willNeed) {
+                posix_fadvise(fd,
+                              CAST<off_t>(range.offset),
+                              CAST<off_t>(range.size),
+                              POSIX_FADV_DONTNEED);
+                continue;
+            }
+
+            size_t size = range.size;
+            if (size == 0) {
+                struct stat info {};
+                if (fstat(fd, &info) == 0 && CAST<u64>(info.st_size) > range.offset) {
+                    size = CAST<size_t>(CAST<u64>(info.st_size) - range.offset);
+                }
+            }
+            // The kernel caps each readahead() at the device's max request or readahead window
+            // size and silently ignores the rest, so queue the range a chunk at a time
+            for (size_t done = 0; done < size; done += kReadaheadChunk) {
+                const u64 offset   = range.offset + done;
+                const size_t chunk = std::min(kReadaheadChunk, size - done);
+                if (readahead(fd, CAST<off64_t>(offset), chunk) != 0) {
+                    posix_fadvise(fd, CAST<off_t>(offset), CAST<off_t>(chunk), POSIX_FADV_WILLNEED);
+                }
+            }
+            gPrefetch.completed.fetch_add(1, std::memory_order_relaxed);
+            gPrefetch.bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+        if (fd >= 0) { close(fd); }
+#else
+        (void)ranges;
+        (void)willNeed;
+#endif
+    }
+
+    static void SubmitCacheHints(std::vector<PrefetchRange> ranges, const bool willNeed) {
+        if (ranges.empty()) { return; }
+        const size_t count = ranges.size();
+        // Hints are only worth anything if they run ahead of the reads, so never wait for a slot
+        const auto submitted = IoPool::Get().TrySubmit(
+          [ranges = std::move(ranges), willNeed] { ApplyCacheHints(ranges, willNeed); },
+          IoPriority::Background);
+        if (!submitted && willNeed) {
+            gPrefetch.dropped.fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+
+    void FileReader::Prefetch(const str& path, const u64 offset, const size_t size) {
+        gPrefetch.requested.fetch_add(1, std::memory_order_relaxed);
+        SubmitCacheHints({{path, offset, size}}, true);
+    }
+
+    void FileReader::Prefetch(std::span<const PrefetchRange> ranges) {
+        gPrefetch.requested.fetch_add(ranges.size(), std::memory_order_relaxed);
+        SubmitCacheHints({ranges.begin(), ranges.end()}, true);
+    }
+
+    void FileReader::Evict(const str& path, const u64 offset, const size_t size) {
+        gPrefetch.evicted.fetch_add(1, std::memory_order_relaxed);
+        SubmitCacheHints({{path, offset, size}}, false);
+    }
+
+    void FileReader::Evict(std::span<const PrefetchRange> ranges) {
+        gPrefetch.evicted.fetch_add(ranges.size(), std::memory_order_relaxed);
+        SubmitCacheHints({ranges.begin(), ranges.end()}, false);
+    }
+
+    PrefetchStats FileReader::GetPrefetchStats() {
+        PrefetchStats stats {};
+        stats.requested      = gPrefetch.requested.load(std::memory_order_relaxed);
+        stats.dropped        = gPrefetch.dropped.load(std::memory_order_relaxed);
+        stats.completed      = gPrefetch.completed.load(std::memory_order_relaxed);
+        stats.failed         = gPrefetch.failed.load(std::memory_order_relaxed);
+        stats.bytes          = gPrefetch.bytes.load(std::memory_order_relaxed);
+        stats.evicted        = gPrefetch.evicted.load(std::memory_order_relaxed);
+        stats.readBlockCalls = gPrefetch.readBlockCalls.load(std::memory_order_relaxed);
+        stats.readBlockNs    = gPrefetch.readBlockNs.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void FileReader::ResetPrefetchStats() {
+        gPrefetch.requested.store(0, std::memory_order_relaxed);
+        gPrefetch.dropped.store(0, std::memory_order_relaxed);
+        gPrefetch.completed.store(0, std::memory_order_relaxed);
+        gPrefetch.failed.store(0, std::memory_order_relaxed);
+        gPrefetch.bytes.store(0, std::memory_order_relaxed);
+        gPrefetch.evicted.store(0, std::memory_order_relaxed);
+        gPrefetch.readBlockCalls.store(0, std::memory_order_relaxed);
+        gPrefetch.readBlockNs.store(0, std::memory_order_relaxed);
+    }
+#pragma endregion
+
+#pragma region MappedFile
+#ifndef _WIN32
+    static int ToMadvise(const MappedFile::AccessHint hint) {
+        switch (hint) {
+            case MappedFile::AccessHint::Sequential:
+                return MADV_SEQUENTIAL;
+            case MappedFile::AccessHint::Random:
+                return MADV_RANDOM;
+            case MappedFile::AccessHint::WillNeed:
+                return MADV_WILLNEED;
+            case MappedFile::AccessHint::DontNeed:
+                return MADV_DONTNEED;
+            default:
+                return MADV_NORMAL;
+        }
+    }
+#endif
+
+    MappedFile::MappedFile(const str& path, const AccessHint hint, const bool hugePages) {
+        Open(path, hint, hugePages);
+    }
+
+    MappedFile::~MappedFile() {
+        Close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : _data(other._data), _size(other._size), _open(other._open) {
+#ifdef _WIN32
+        _file          = other._file;
+        _mapping       = other._mapping;
+        other._file    = None;
+        other._mapping = None;
+#endif
+        other._data = None;
+        other._size = 0;
+        other._open = false;
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            Close();
+            _data = other._data;
+            _size = other._size;
+            _open = other._open;
+#ifdef _WIN32
+            _file          = other._file;
+            _mapping       = other._mapping;
+            other._file    = None;
+            other._mapping = None;
+#endif
+            other._data = None;
+            other._size = 0;
+            other._open = false;
+        }
+        return *this;
+    }
+
+    bool MappedFile::Open(const str& path, const AccessHint hint, const bool hugePages) {
+        Close();
+
+#ifdef _WIN32
+        (void)hugePages;  // Large pages require SeLockMemoryPrivilege, not worth it for files
+        HANDLE file = CreateFileA(path.c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ,
+                                  None,
+                                  OPEN_EXISTING,
+                                  hint == AccessHint::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN
+                                  : hint == AccessHint::Random   ? FILE_FLAG_RANDOM_ACCESS
+                                                                 : FILE_ATTRIBUTE_NORMAL,
+                                  None);
+        if (file == INVALID_HANDLE_VALUE) { return false; }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            return false;
+        }
+
+        _file = file;
+        _size = CAST<size_t>(fileSize.QuadPart);
+        _open = true;
+        if (_size == 0) { return true; }  // Can't map an empty file, but it's still a valid file
+
+        _mapping = CreateFileMappingA(file, None, PAGE_READONLY, 0, 0, None);
+        if (!_mapping) {
+            Close();
+            return false;
+        }
+        _data = CAST<u8*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!_data) {
+            Close();
+            return false;
+        }
+#else
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) { return false; }
+
+        struct stat info {};
+        if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+            close(fd);
+            return false;
+        }
+
+        _size = CAST<size_t>(info.st_size);
+        _open = true;
+        if (_size == 0) {
+            close(fd);
+            return true;  // Can't map an empty file, but it's still a valid file
+        }
+
+        void* mapping = MAP_FAILED;
+    #ifdef MAP_HUGETLB
+        if (hugePages) {
+            mapping = mmap(None, _size, PROT_READ, MAP_PRIVATE | MAP_HUGETLB, fd, 0);
+        }
+    #endif
+        if (mapping == MAP_FAILED) { mapping = mmap(None, _size, PROT_READ, MAP_PRIVATE, fd, 0); }
+        // The mapping holds its own reference to the file, the descriptor isn't needed anymore
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            _size = 0;
+            _open = false;
+            return false;
+        }
+
+        _data = CAST<u8*>(mapping);
+    #ifdef MADV_HUGEPAGE
+        if (hugePages) { madvise(_data, _size, MADV_HUGEPAGE); }
+    #endif
+        if (hint != AccessHint::Normal) { Advise(hint); }
+#endif
+
+        return true;
+    }
+
+    void MappedFile::Close() {
+#ifdef _WIN32
+        if (_data) { UnmapViewOfFile(_data); }
+        if (_mapping) { CloseHandle(_mapping); }
+        if (_file) { CloseHandle(_file); }
+        _mapping = None;
+        _file    = None;
+#else
+        if (_data) { munmap(_data, _size); }
+#endif
+        _data = None;
+        _size = 0;
+        _open = false;
+    }
+
+    void MappedFile::Advise(const AccessHint hint, const u64 offset, const size_t size) const {
+        if (!_data || offset >= _size) { return; }
+        const size_t length = size == 0 ? _size - offset : std::min<size_t>(size, _size - offset);
+
+#ifdef _WIN32
+        if (hint == AccessHint::WillNeed) {
+            WIN32_MEMORY_RANGE_ENTRY range;
+            range.VirtualAddress = _data + offset;
+            range.NumberOfBytes  = length;
+            PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+        }
+#else
+        // madvise() wants a page aligned address, so round the start of the range down
+        static const auto pageSize = CAST<u64>(sysconf(_SC_PAGESIZE));
+        const u64 alignedOffset    = offset & ~(pageSize - 1);
+        madvise(_data + alignedOffset, length + (offset - alignedOffset), ToMadvise(hint));
+#endif
+    }
+
+    bool MappedFile::IsOpen() const {
+        return _open;
+    }
+
+    size_t MappedFile::Size() const {
+        return _size;
+    }
+
+    std::span<const u8> MappedFile::Data() const {
+        return {_data, _size};
+    }
+
+    std::span<const u8> MappedFile::Slice(const u64 offset, const size_t size) const {
+        if (offset >= _size || size == 0 || offset + size > _size) { return {}; }
+        return {_data + offset, size};
+    }
+
+    std::string_view MappedFile::Text() const {
+        return {RCAST<const char*>(_data), _size};
+    }
+#pragma endregion
+
+#pragma region LineRange
+    LineRange::Iterator::Iterator(const char* begin, const char* end) : _next(begin), _end(end) {
+        ++*this;
+    }
+
+    LineRange::Iterator& LineRange::Iterator::operator++() {
+        if (_next == _end) {
+            _next = None;
+            _line = {};
+            return *this;
+        }
+
+        // glibc's memchr is vectorized (SSE2/AVX2/EVEX picked at load time), which beats a
+        // hand-rolled loop even on short lines
+        const auto* newline =
+          CAST<const char*>(std::memchr(_next, '\n', CAST<size_t>(_end - _next)));
+        const char* lineEnd = newline ? newline : _end;
+        _line               = std::string_view(_next, CAST<size_t>(lineEnd - _next));
+        if (!_line.empty() && _line.back() == '\r') { _line.remove_suffix(1); }
+        _next = newline ? newline + 1 : _end;
+        return *this;
+    }
+
+    LineRange::Iterator LineRange::Iterator::operator++(int) {
+        Iterator previous = *this;
+        ++*this;
+        return previous;
+    }
+
+    LineRange::Iterator LineRange::begin() const {
+        if (_text.empty()) { return end(); }
+        return {_text.data(), _text.data() + _text.size()};
+    }
+
+    LineRange::Iterator LineRange::end() const {
+        return {};
     }
 #pragma endregion
 
 #pragma region FileWriter
-    bool FileWriter::WriteAllBytes(const str& path, const std::vector<u8>& data) {
-        std::ofstream file(path,
-                           std::ios::binary | std::ios::trunc);  // Overwrite existing file
-        if (!file) return false;
-        file.write(RCAST<const char*>(data.data()), CAST<std::streamsize>(data.size()));
-        return file.good();
+    // Drops the cached metadata of a path we just created or wrote, and of its directory, so an
+    // earlier Exists() that cached it as missing doesn't outlive the write
+    static void InvalidateCached(std::string_view path) {
+        auto& cache = MetadataCache::Get();
+        if (!cache.IsEnabled()) { return; }
+        const PathId id(path);
+        cache.Invalidate(id);
+        cache.Invalidate(id.Parent());
     }
 
-    bool FileWriter::WriteAllText(const str& path, const str& text) {
+    bool FileWriter::WriteAllBytes(const str& path,
+                                   const std::vector<u8>& data,
+                                   const WriteMode mode) {
+        const std::span<const u8> buffer = data;
+        return TryWriteAllBytes(path, {&buffer, 1}, mode).HasValue();
+    }
+
+    bool FileWriter::WriteAllText(const str& path, const str& text, const WriteMode mode) {
+        if (mode == WriteMode::Atomic) {
+            const std::span buffer(RCAST<const u8*>(text.data()), text.size());
+            return WriteAtomic(path, {&buffer, 1}).HasValue();
+        }
         std::ofstream file(path, std::ios::out | std::ios::trunc);
         if (!file) return false;
         file << text;
-        return file.good();
+        file.close();
+        InvalidateCached(path);
+        return !file.fail();
     }
 
-    bool FileWriter::WriteAllLines(const str& path, const std::vector<str>& lines) {
+    bool FileWriter::WriteAllLines(const str& path,
+                                   const std::vector<str>& lines,
+                                   const WriteMode mode) {
+        if (mode == WriteMode::Atomic) {
+            str text;
+            for (const auto& line : lines) {
+                text.append(line).append(1, '\n');
+            }
+            const std::span buffer(RCAST<const u8*>(text.data()), text.size());
+            return WriteAtomic(path, {&buffer, 1}).HasValue();
+        }
         std::ofstream file(path, std::ios::out | std::ios::trunc);
         if (!file) return false;
         for (const auto& line : lines) {
             file << line << '\n';
-            if (!file.good()) { return false; }
+            if (!file.good()) { break; }
         }
-        return file.good();
+        file.close();
+        InvalidateCached(path);
+        return !file.fail();
     }
 
-    bool FileWriter::WriteBlock(const str& path, const std::vector<u8>& data, u64 offset) {
-        std::ofstream file(path,
-                           std::ios::binary | std::ios::in |
-                             std::ios::out);  // Open in binary read/write mode
-        if (!file) return false;
-        file.seekp(CAST<std::streampos>(offset), std::ios::beg);  // seek to offset
-        if (!file) return false;                                  // Failed to seek
-        file.write(RCAST<const char*>(data.data()), CAST<std::streamsize>(data.size()));
-        return file.good();
+    bool FileWriter::WriteBlock(const str& path, const std::vector<u8>& data, const u64 offset) {
+        const std::span<const u8> buffer = data;
+        return TryWriteBlock(path, {&buffer, 1}, offset).HasValue();
     }
 
-    std::future<std::vector<u8>> AsyncFileReader::ReadAllBytes(const str& path) {
-        return runAsync([path]() { return FileReader::ReadAllBytes(path); });
+    bool FileWriter::WriteAllBytes(const str& path,
+                                   std::span<const std::span<const u8>> buffers,
+                                   const WriteMode mode) {
+        return TryWriteAllBytes(path, buffers, mode).HasValue();
     }
 
-    std::future<str> AsyncFileReader::ReadAllText(const str& path) {
-        return runAsync([path]() { return FileReader::ReadAllText(path); });
+    bool FileWriter::WriteBlock(const str& path,
+                                std::span<const std::span<const u8>> buffers,
+                                const u64 offset) {
+        return TryWriteBlock(path, buffers, offset).HasValue();
     }
 
-    std::future<std::vector<str>> AsyncFileReader::ReadAllLines(const str& path) {
-        return runAsync([path]() { return FileReader::ReadAllLines(path); });
+    FsResult<void> FileWriter::TryWriteAllBytes(const str& path,
+                                                std::span<const std::span<const u8>> buffers,
+                                                const WriteMode mode) {
+        if (mode == WriteMode::Atomic) { return WriteAtomic(path, buffers); }
+#ifdef _WIN32
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) { return Unexpected(FsError {EACCES}); }
+        for (const auto& buffer : buffers) {
+            file.write(RCAST<const char*>(buffer.data()), CAST<std::streamsize>(buffer.size()));
+        }
+        file.close();
+        InvalidateCached(path);
+        if (file.fail()) { return Unexpected(FsError {EIO}); }
+        return {};
+#else
+        const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) { return LastError(); }
+        auto result = CloseAfterWrite(fd, WriteVectored(fd, buffers, 0));
+        InvalidateCached(path);
+        return result;
+#endif
+    }
+
+    FsResult<void> FileWriter::TryWriteBlock(const str& path,
+                                             std::span<const std::span<const u8>> buffers,
+                                             const u64 offset) {
+#ifdef _WIN32
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file) { file.open(path, std::ios::binary | std::ios::out); }
+        if (!file) { return Unexpected(FsError {EACCES}); }
+        file.seekp(CAST<std::streamoff>(offset), std::ios::beg);
+        for (const auto& buffer : buffers) {
+            file.write(RCAST<const char*>(buffer.data()), CAST<std::streamsize>(buffer.size()));
+        }
+        file.close();
+        InvalidateCached(path);
+        if (file.fail()) { return Unexpected(FsError {EIO}); }
+        return {};
+#else
+        const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) { return LastError(); }
+        auto result = CloseAfterWrite(fd, WriteVectored(fd, buffers, offset));
+        InvalidateCached(path);
+        return result;
+#endif
     }
 
-    std::future<std::vector<u8>>
-    AsyncFileReader::ReadBlock(const str& path, size_t size, u64 offset) {
+    // Temp files sit next to their target so the rename never crosses filesystems
+    static str TempPathFor(const str& path) {
+        static std::atomic<u64> counter {0};
+#ifdef _WIN32
+        const u64 pid = GetCurrentProcessId();
+#else
+        const u64 pid = CAST<u64>(getpid());
+#endif
+        return path + "." + std::to_string(pid) + "." + std::to_string(counter++) + ".tmp";
+    }
+
+#ifndef _WIN32
+
+    static str ParentDirectory(const str& path) {
+        const size_t separator = path.find_last_of('/');
+        return separator == str::npos ? "." : path.substr(0, separator + 1);
+    }
+
+    // A rename is only durable once the directory holding the file is synced too
+    static void SyncDirectory(const str& dir) {
+        const int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) { return; }
+        fsync(fd);
+        close(fd);
+    }
+
+    // The temp file is renamed over `target`, so it takes over the target's permissions
+    static int CreateTempFile(const str& tempPath, const str& target) {
+        const int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) { return fd; }
+
+        struct stat info {};
+        if (stat(target.c_str(), &info) == 0 && fchmod(fd, info.st_mode & 07777) != 0) {
+            const int error = errno;
+            close(fd);
+            unlink(tempPath.c_str());
+            errno = error;
+            return -1;
+        }
+        return fd;
+    }
+#endif
+
+    FsResult<void> FileWriter::WriteAtomic(const str& path,
+                                           std::span<const std::span<const u8>> buffers) {
+        const str tempPath = TempPathFor(path);
+#ifdef _WIN32
+        const HANDLE file = CreateFileA(tempPath.c_str(),
+                                        GENERIC_WRITE,
+                                        0,
+                                        None,
+                                        CREATE_ALWAYS,
+                                        FILE_ATTRIBUTE_NORMAL,
+                                        None);
+        if (file == INVALID_HANDLE_VALUE) { return Unexpected(FsError {EACCES}); }
+
+        bool ok = true;
+        for (auto data : buffers) {
+            while (ok && !data.empty()) {
+                const DWORD chunk = CAST<DWORD>(std::min<size_t>(data.size(), 1u << 30));
+                DWORD written     = 0;
+                ok   = WriteFile(file, data.data(), chunk, &written, None) && written > 0;
+                data = data.subspan(written);
+            }
+        }
+        ok = ok && FlushFileBuffers(file);
+        CloseHandle(file);
+
+        if (!ok || !MoveFileExA(tempPath.c_str(),
+                                path.c_str(),
+                                MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+            DeleteFileA(tempPath.c_str());
+            return Unexpected(FsError {EIO});
+        }
+        InvalidateCached(path);
+        return {};
+#else
+        const int fd = CreateTempFile(tempPath, path);
+        if (fd < 0) { return LastError(); }
+
+        const bool ok   = WriteVectored(fd, buffers, 0) && fdatasync(fd) == 0;
+        const int error = errno;
+        close(fd);
+        if (!ok || rename(tempPath.c_str(), path.c_str()) != 0) {
+            const auto result = Unexpected(FsError {ok ? errno : error});
+            unlink(tempPath.c_str());
+            return result;
+        }
+        SyncDirectory(ParentDirectory(path));
+        InvalidateCached(path);
+        return {};
+#endif
+    }
+
+    GroupCommitWriter::GroupCommitWriter(const GroupCommitConfig& config) : _config(config) {
+        _config.maxBatch = std::max(_config.maxBatch, 1u);
+        _thread          = std::thread(&GroupCommitWriter::CommitLoop, this);
+    }
+
+    GroupCommitWriter::~GroupCommitWriter() {
+        {
+            std::lock_guard lock(_mutex);
+            _stop = true;
+        }
+        _cv.notify_all();
+        _thread.join();
+    }
+
+    std::future<bool> GroupCommitWriter::Write(const str& path, std::vector<u8> data) {
+        std::promise<bool> promise;
+        auto future = promise.get_future();
+        {
+            std::lock_guard lock(_mutex);
+            _queue.push_back({path, std::move(data), std::move(promise)});
+        }
+        _cv.notify_all();
+        return future;
+    }
+
+    void GroupCommitWriter::Flush() {
+        std::unique_lock lock(_mutex);
+        _flushing = true;
+        _cv.notify_all();
+        _idleCv.wait(lock, [this] { return _queue.empty() && !_committing; });
+        _flushing = false;
+    }
+
+    void GroupCommitWriter::CommitLoop() {
+        std::vector<Pending> batch;
+        std::unique_lock lock(_mutex);
+        for (;;) {
+            _cv.wait(lock, [this] { return !_queue.empty() || _stop; });
+            if (_queue.empty()) { return; }  // Stopping with nothing left to commit
+
+            // Give other writers a moment to join the batch, unless someone is waiting on it
+            const auto deadline =
+              std::chrono::steady_clock::now() + std::chrono::microseconds(_config.maxDelayUs);
+            _cv.wait_until(lock, deadline, [this] {
+                return _queue.size() >= _config.maxBatch || _flushing || _stop;
+            });
+
+            const size_t count = std::min<size_t>(_queue.size(), _config.maxBatch);
+            batch.assign(std::make_move_iterator(_queue.begin()),
+                         std::make_move_iterator(_queue.begin() + CAST<i64>(count)));
+            _queue.erase(_queue.begin(), _queue.begin() + CAST<i64>(count));
+            _committing = true;
+            lock.unlock();
+
+            Commit(batch);
+            batch.clear();
+
+            lock.lock();
+            _committing = false;
+            _idleCv.notify_all();
+        }
+    }
+
+    void GroupCommitWriter::Commit(std::vector<Pending>& batch) {
+        // Only the last write to each path gets stored, earlier ones share its result
+        unordered_map<std::string_view, size_t> latest;
+        for (size_t i = 0; i < batch.size(); i++) {
+            latest[batch[i].path] = i;
+        }
+
+        std::vector<char> results(batch.size(), false);
+#ifdef _WIN32
+        for (const auto& [path, index] : latest) {
+            results[index] = FileWriter::WriteAllBytes(batch[index].path,
+                                                       batch[index].data,
+                                                       WriteMode::Atomic);
+        }
+#else
+        struct Staged {
+            size_t index;
+            str tempPath;
+            int fd;
+        };
+        std::vector<Staged> staged;
+        staged.reserve(latest.size());
+        for (const auto& [path, index] : latest) {
+            Staged file {index, TempPathFor(batch[index].path), -1};
+            file.fd = CreateTempFile(file.tempPath, batch[index].path);
+            if (file.fd < 0) { continue; }
+            const std::span<const u8> data = batch[index].data;
+            if (!WriteVectored(file.fd, {&data, 1}, 0)) {
+                close(file.fd);
+                unlink(file.tempPath.c_str());
+                continue;
+            }
+            staged.push_back(std::move(file));
+        }
+
+        // One sync for the whole batch. syncfs() writes back everything dirty on the filesystem
+        // in a single journal commit, instead of one commit per fdatasync()
+        std::vector<char> synced(staged.size(), false);
+    #ifdef __linux__
+        unordered_map<dev_t, bool> devices;
+        for (size_t i = 0; i < staged.size(); i++) {
+            struct stat info {};
+            if (fstat(staged[i].fd, &info) != 0) { continue; }
+            const auto [it, inserted] = devices.try_emplace(info.st_dev, false);
+            if (inserted) { it->second = syncfs(staged[i].fd) == 0; }
+            synced[i] = it->second;
+        }
+    #endif
+        for (size_t i = 0; i < staged.size(); i++) {
+            if (!synced[i]) { synced[i] = fdatasync(staged[i].fd) == 0; }
+            close(staged[i].fd);
+        }
+
+        std::vector<str> dirs;
+        for (size_t i = 0; i < staged.size(); i++) {
+            const str& path = batch[staged[i].index].path;
+            if (!synced[i] || rename(staged[i].tempPath.c_str(), path.c_str()) != 0) {
+                unlink(staged[i].tempPath.c_str());
+                continue;
+            }
+            results[staged[i].index] = true;
+            dirs.push_back(ParentDirectory(path));
+            InvalidateCached(path);
+        }
+
+        std::ranges::sort(dirs);
+        const auto [first, last] = std::ranges::unique(dirs);
+        dirs.erase(first, last);
+        for (const str& dir : dirs) {
+            SyncDirectory(dir);
+        }
+#endif
+
+        for (size_t i = 0; i < batch.size(); i++) {
+            batch[i].promise.set_value(results[latest[batch[i].path]]);
+        }
+    }
+
+    std::future<std::vector<u8>> AsyncFileReader::ReadAllBytes(const str& path,
+                                                               IoPriority priority,
+                                                               const CancellationToken& cancel) {
+        return runAsync([path]() { return FileReader::ReadAllBytes(path); }, priority, cancel);
+    }
+
+    std::future<str> AsyncFileReader::ReadAllText(const str& path,
+                                                  IoPriority priority,
+                                                  const CancellationToken& cancel) {
+        return runAsync([path]() { return FileReader::ReadAllText(path); }, priority, cancel);
+    }
+
+    std::future<std::vector<str>> AsyncFileReader::ReadAllLines(const str& path,
+                                                                IoPriority priority,
+                                                                const CancellationToken& cancel) {
+        return runAsync([path]() { return FileReader::ReadAllLines(path); }, priority, cancel);
+    }
+
+    std::future<std::vector<u8>> AsyncFileReader::ReadBlock(const str& path,
+                                                            size_t size,
+                                                            u64 offset,
+                                                            IoPriority priority,
+                                                            const CancellationToken& cancel) {
+        return runAsync(
+          [path, size, offset]() { return FileReader::ReadBlock(path, size, offset); },
+          priority,
+          cancel);
+    }
+
+    std::future<FsResult<size_t>> AsyncFileReader::ReadBlock(const str& path,
+                                                             std::span<u8> dest,
+                                                             u64 offset,
+                                                             IoPriority priority,
+                                                             const CancellationToken& cancel) {
         return runAsync(
-          [path, size, offset]() { return FileReader::ReadBlock(path, size, offset); });
+          [path, dest, offset]() { return FileReader::ReadBlock(path, dest, offset); },
+          priority,
+          cancel);
+    }
+
+    std::future<std::pair<PooledBuffer, FsResult<size_t>>>
+    AsyncFileReader::ReadBlock(const str& path,
+                               BufferPool& pool,
+                               u64 offset,
+                               IoPriority priority,
+                               const CancellationToken& cancel) {
+        return runAsync(
+          [path, &pool, offset]() {
+              PooledBuffer buffer = pool.Acquire();
+              auto result         = FileReader::ReadBlock(path, buffer.Span(), offset);
+              return std::pair(std::move(buffer), std::move(result));
+          },
+          priority,
+          cancel);
+    }
+
+    static std::atomic gBatchBackend = AsyncFileReader::BatchBackend::Auto;
+
+    // None once the ring stopped working, reads then go through the IoPool instead
+    static IoUring* SharedRing() {
+        static IoUring ring(256);
+        return ring.IsValid() ? &ring : None;
+    }
+
+    // The ring can break at any time, so callers check the returned pointer and not
+    // IsUsingIoUring()
+    static IoUring* ActiveRing() {
+        if (gBatchBackend.load(std::memory_order_relaxed) != AsyncFileReader::BatchBackend::Auto) {
+            return None;
+        }
+        return SharedRing();
+    }
+
+    std::future<bool> AsyncFileReader::ReadBlocks(std::span<ReadRequest> requests,
+                                                  bool directIo,
+                                                  IoPriority priority,
+                                                  const CancellationToken& cancel) {
+        if (IoUring* ring = ActiveRing()) { return ring->SubmitReads(requests, directIo); }
+        // The pread fallback ignores directIo, it's a page cache hint and not a requirement
+        return runAsync([requests]() { return FileReader::ReadBlocks(requests); },
+                        priority,
+                        cancel);
+    }
+
+    bool AsyncFileReader::RegisterBuffers(std::span<const std::span<u8>> buffers) {
+        IoUring* ring = ActiveRing();
+        return ring && ring->RegisterBuffers(buffers);
+    }
+
+    void AsyncFileReader::SetBatchBackend(const BatchBackend backend) {
+        gBatchBackend.store(backend, std::memory_order_relaxed);
     }
 
-    std::future<bool> AsyncFileWriter::WriteAllBytes(const str& path, const std::vector<u8>& data) {
-        return runAsync([path, data]() { return FileWriter::WriteAllBytes(path, data); });
+    bool AsyncFileReader::IsUsingIoUring() {
+        return ActiveRing() != None;
     }
 
-    std::future<bool> AsyncFileWriter::WriteAllText(const str& path, const str& text) {
-        return runAsync([path, text]() { return FileWriter::WriteAllText(path, text); });
+    std::future<bool> AsyncFileWriter::WriteAllBytes(const str& path,
+                                                     const std::vector<u8>& data,
+                                                     IoPriority priority,
+                                                     const CancellationToken& cancel) {
+        return runAsync([path, data]() { return FileWriter::WriteAllBytes(path, data); },
+                        priority,
+                        cancel);
+    }
+
+    std::future<bool> AsyncFileWriter::WriteAllText(const str& path,
+                                                    const str& text,
+                                                    IoPriority priority,
+                                                    const CancellationToken& cancel) {
+        return runAsync([path, text]() { return FileWriter::WriteAllText(path, text); },
+                        priority,
+                        cancel);
     }
 
     std::future<bool> AsyncFileWriter::WriteAllLines(const str& path,
-                                                     const std::vector<str>& lines) {
-        return runAsync([path, lines]() { return FileWriter::WriteAllLines(path, lines); });
+                                                     const std::vector<str>& lines,
+                                                     IoPriority priority,
+                                                     const CancellationToken& cancel) {
+        return runAsync([path, lines]() { return FileWriter::WriteAllLines(path, lines); },
+                        priority,
+                        cancel);
     }
 
-    std::future<bool>
-    AsyncFileWriter::WriteBlock(const str& path, const std::vector<u8>& data, u64 offset) {
+    std::future<bool> AsyncFileWriter::WriteBlock(const str& path,
+                                                  const std::vector<u8>& data,
+                                                  u64 offset,
+                                                  IoPriority priority,
+                                                  const CancellationToken& cancel) {
         return runAsync(
-          [path, data, offset]() { return FileWriter::WriteBlock(path, data, offset); });
+          [path, data, offset]() { return FileWriter::WriteBlock(path, data, offset); },
+          priority,
+          cancel);
+    }
+#pragma endregion
+
+#pragma region AwaitableFileReader
+    IoAwaitable<FsResult<std::vector<u8>>> AwaitableFileReader::ReadAllBytes(
+      const str& path, Executor& executor, const IoPriority priority) {
+        return {[path] { return FileReader::TryReadAllBytes(path); }, executor, priority};
+    }
+
+    IoAwaitable<FsResult<str>> AwaitableFileReader::ReadAllText(const str& path,
+                                                                Executor& executor,
+                                                                const IoPriority priority) {
+        return {[path] { return FileReader::TryReadAllText(path); }, executor, priority};
+    }
+
+    IoAwaitable<std::vector<str>> AwaitableFileReader::ReadAllLines(const str& path,
+                                                                    Executor& executor,
+                                                                    const IoPriority priority) {
+        return {[path] { return FileReader::ReadAllLines(path); }, executor, priority};
+    }
+
+    IoAwaitable<FsResult<std::vector<u8>>>
+    AwaitableFileReader::ReadBlock(const str& path,
+                                   const size_t size,
+                                   const u64 offset,
+                                   Executor& executor,
+                                   const IoPriority priority) {
+        return {[path, size, offset] { return FileReader::TryReadBlock(path, size, offset); },
+                executor,
+                priority};
+    }
+
+    IoAwaitable<FsResult<size_t>> AwaitableFileReader::ReadBlock(const str& path,
+                                                                 std::span<u8> dest,
+                                                                 const u64 offset,
+                                                                 Executor& executor,
+                                                                 const IoPriority priority) {
+        return {[path, dest, offset] { return FileReader::ReadBlock(path, dest, offset); },
+                executor,
+                priority};
+    }
+#pragma endregion
+
+#pragma region AwaitableFileWriter
+    IoAwaitable<FsResult<void>> AwaitableFileWriter::WriteAllBytes(const str& path,
+                                                                   std::vector<u8> data,
+                                                                   const WriteMode mode,
+                                                                   Executor& executor,
+                                                                   const IoPriority priority) {
+        // std::function needs a copyable callable, so the buffer rides in a shared_ptr
+        auto shared = make_shared<std::vector<u8>>(std::move(data));
+        return {[path, shared, mode] {
+                    const std::span<const u8> buffer(*shared);
+                    return FileWriter::TryWriteAllBytes(path, {&buffer, 1}, mode);
+                },
+                executor,
+                priority};
+    }
+
+    IoAwaitable<FsResult<void>> AwaitableFileWriter::WriteAllText(const str& path,
+                                                                  str text,
+                                                                  const WriteMode mode,
+                                                                  Executor& executor,
+                                                                  const IoPriority priority) {
+        auto shared = make_shared<str>(std::move(text));
+        return {[path, shared, mode] {
+                    const std::span buffer(RCAST<const u8*>(shared->data()), shared->size());
+                    return FileWriter::TryWriteAllBytes(path, {&buffer, 1}, mode);
+                },
+                executor,
+                priority};
+    }
+
+    IoAwaitable<FsResult<void>> AwaitableFileWriter::WriteAllLines(const str& path,
+                                                                   std::vector<str> lines,
+                                                                   const WriteMode mode,
+                                                                   Executor& executor,
+                                                                   const IoPriority priority) {
+        auto shared = make_shared<std::vector<str>>(std::move(lines));
+        return {[path, shared, mode] {
+                    str text;
+                    for (const auto& line : *shared) {
+                        text.append(line).append(1, '\n');
+                    }
+                    const std::span buffer(RCAST<const u8*>(text.data()), text.size());
+                    return FileWriter::TryWriteAllBytes(path, {&buffer, 1}, mode);
+                },
+                executor,
+                priority};
+    }
+
+    IoAwaitable<FsResult<void>> AwaitableFileWriter::WriteBlock(const str& path,
+                                                                std::vector<u8> data,
+                                                                const u64 offset,
+                                                                Executor& executor,
+                                                                const IoPriority priority) {
+        auto shared = make_shared<std::vector<u8>>(std::move(data));
+        return {[path, shared, offset] {
+                    const std::span<const u8> buffer(*shared);
+                    return FileWriter::TryWriteBlock(path, {&buffer, 1}, offset);
+                },
+                executor,
+                priority};
+    }
+#pragma endregion
+
+#pragma region StreamReader
+    StreamReader::StreamReader(const str& path, const size_t bufferSize)
+        : _buffer(std::max<size_t>(bufferSize, 16)) {
+        // We do our own buffering, don't let the filebuf copy everything a second time
+        _file.rdbuf()->pubsetbuf(None, 0);
+        _file.open(path, std::ios::binary | std::ios::ate);
+        if (!_file.is_open()) { return; }
+        _size = CAST<u64>(_file.tellg());
+        _file.seekg(0, std::ios::beg);
+    }
+
+    size_t StreamReader::Read(std::span<u8> dest) {
+        size_t total = 0;
+        while (total < dest.size()) {
+            const size_t buffered  = _bufferLen - _bufferPos;
+            const size_t remaining = dest.size() - total;
+            if (buffered > 0) {
+                const size_t count = std::min(buffered, remaining);
+                std::memcpy(dest.data() + total, _buffer.data() + _bufferPos, count);
+                _bufferPos += count;
+                total += count;
+                continue;
+            }
+
+            if (remaining >= _buffer.size()) {
+                // Big reads skip the buffer entirely
+                _bufferStart += _bufferLen;
+                _bufferPos = _bufferLen = 0;
+                _file.read(RCAST<char*>(dest.data() + total), CAST<std::streamsize>(remaining));
+                const auto count = CAST<size_t>(_file.gcount());
+                _file.clear();
+                _bufferStart += count;
+                total += count;
+                break;
+            }
+
+            if (!Refill()) { break; }
+        }
+        return total;
+    }
+
+    bool StreamReader::Refill() {
+        if (!_file.is_open()) { return false; }
+        _bufferStart += _bufferLen;
+        _bufferPos = _bufferLen = 0;
+        _file.read(RCAST<char*>(_buffer.data()), CAST<std::streamsize>(_buffer.size()));
+        _bufferLen = CAST<size_t>(_file.gcount());
+        _file.clear();  // Hitting EOF sets failbit, which would break the next Seek()
+        return _bufferLen > 0;
+    }
+
+    bool StreamReader::Seek(const u64 offset) {
+        if (!_file.is_open() || offset > _size) { return false; }
+        if (offset >= _bufferStart && offset <= _bufferStart + _bufferLen) {
+            _bufferPos = CAST<size_t>(offset - _bufferStart);
+            return true;
+        }
+        _file.seekg(CAST<std::streamoff>(offset), std::ios::beg);
+        _bufferStart = offset;
+        _bufferPos = _bufferLen = 0;
+        return _file.good();
+    }
+
+    bool StreamReader::Skip(const u64 count) {
+        return Seek(Tell() + count);
+    }
+
+    u64 StreamReader::Tell() const {
+        return _bufferStart + _bufferPos;
+    }
+
+    u64 StreamReader::Size() const {
+        return _size;
+    }
+
+    bool StreamReader::IsOpen() const {
+        return _file.is_open();
+    }
+
+    bool StreamReader::IsEof() const {
+        return Tell() >= _size;
+    }
+#pragma endregion
+
+#pragma region StreamWriter
+    StreamWriter::StreamWriter(const str& path, const bool append, const size_t bufferSize)
+        : _buffer(std::max<size_t>(bufferSize, 16)) {
+        _file.rdbuf()->pubsetbuf(None, 0);
+        if (append) {
+            // in|out keeps the existing contents and, unlike app, still lets us seek
+            _file.open(path, std::ios::binary | std::ios::in | std::ios::out);
+            if (_file.is_open()) {
+                _file.seekp(0, std::ios::end);
+                _bufferStart = CAST<u64>(_file.tellp());
+                return;
+            }
+        }
+        _file.open(path, std::ios::binary | std::ios::out | std::ios::trunc);
+        if (_file.is_open()) { InvalidateCached(path); }
+    }
+
+    StreamWriter::~StreamWriter() {
+        Flush();
+    }
+
+    StreamWriter::StreamWriter(StreamWriter&& other) noexcept
+        : _file(std::move(other._file)), _buffer(std::move(other._buffer)),
+          _bufferLen(other._bufferLen), _bufferStart(other._bufferStart) {
+        other._bufferLen = 0;
+    }
+
+    StreamWriter& StreamWriter::operator=(StreamWriter&& other) noexcept {
+        if (this != &other) {
+            Flush();
+            _file            = std::move(other._file);
+            _buffer          = std::move(other._buffer);
+            _bufferLen       = other._bufferLen;
+            _bufferStart     = other._bufferStart;
+            other._bufferLen = 0;
+        }
+        return *this;
+    }
+
+    bool StreamWriter::Write(std::span<const u8> data) {
+        if (!_file.is_open()) { return false; }
+        if (data.empty()) { return true; }
+        if (_buffer.size() - _bufferLen >= data.size()) {
+            std::memcpy(_buffer.data() + _bufferLen, data.data(), data.size());
+            _bufferLen += data.size();
+            return true;
+        }
+
+        if (!Flush()) { return false; }
+        if (data.size() >= _buffer.size()) {
+            _file.write(RCAST<const char*>(data.data()), CAST<std::streamsize>(data.size()));
+            _bufferStart += data.size();
+            return _file.good();
+        }
+        std::memcpy(_buffer.data(), data.data(), data.size());
+        _bufferLen = data.size();
+        return true;
+    }
+
+    bool StreamWriter::Flush() {
+        if (!_file.is_open()) { return false; }
+        if (_bufferLen > 0) {
+            _file.write(RCAST<const char*>(_buffer.data()), CAST<std::streamsize>(_bufferLen));
+            _bufferStart += _bufferLen;
+            _bufferLen = 0;
+        }
+        return _file.good();
+    }
+
+    bool StreamWriter::Seek(const u64 offset) {
+        if (!Flush()) { return false; }
+        _file.seekp(CAST<std::streamoff>(offset), std::ios::beg);
+        _bufferStart = offset;
+        return _file.good();
+    }
+
+    u64 StreamWriter::Tell() const {
+        return _bufferStart + _bufferLen;
+    }
+
+    bool StreamWriter::IsOpen() const {
+        return _file.is_open();
+    }
+#pragma endregion
+
+#pragma region PathId
+    static bool IsSeparator(const char c) {
+        return c == '/' || c == PATH_SEPARATOR;
+    }
+
+    // Hands `func` a scratch buffer of `size` chars, on the stack unless the path is unusually long
+    template<typename Func>
+    static auto WithPathBuffer(const size_t size, Func&& func) {
+        if (size <= kMaxPathLength) {
+            char buffer[kMaxPathLength];
+            return func(std::span(buffer, size));
+        }
+        str buffer(size, '\0');
+        return func(std::span(buffer));
+    }
+
+    size_t NormalizePath(std::string_view path, std::span<char> out, const char separator) {
+        if (out.size() < std::max<size_t>(path.size(), 1)) { return 0; }
+
+        // Components are only ever moved towards the front, so writing at `length` never
+        // clobbers input that hasn't been read yet when `out` aliases `path`
+        const bool rooted = !path.empty() && IsSeparator(path[0]);
+        const size_t base = rooted ? 1 : 0;
+        size_t length     = base;
+        if (rooted) { out[0] = separator; }
+
+        size_t pos = 0;
+        while (pos < path.size()) {
+            while (pos < path.size() && IsSeparator(path[pos])) {
+                pos++;
+            }
+            const size_t start = pos;
+            while (pos < path.size() && !IsSeparator(path[pos])) {
+                pos++;
+            }
+            const std::string_view part = path.substr(start, pos - start);
+            if (part.empty() || part == ".") { continue; }
+
+            if (part == ".." && rooted && length == base) { continue; }  // "/.." is "/"
+            if (part == ".." && length > base) {
+                size_t last = length;
+                while (last > base && out[last - 1] != separator) {
+                    last--;
+                }
+                if (std::string_view(out.data() + last, length - last) != "..") {
+                    length = last > base ? last - 1 : base;
+                    continue;
+                }
+            }
+
+            if (length > base) { out[length++] = separator; }
+            std::memmove(out.data() + length, part.data(), part.size());
+            length += part.size();
+        }
+
+        if (length == 0) { out[length++] = '.'; }
+        return length;
+    }
+
+    // Process-wide storage behind PathId. Strings are copied into fixed blocks that are never
+    // freed or moved, so the views handed out by PathId::Str() stay valid.
+    class PathTable {
+    public:
+        static PathTable& Get() {
+            static PathTable table;
+            return table;
+        }
+
+        u64 Intern(std::string_view path) {
+            const u64 hash = Fnv1a64(path);
+            {
+                std::shared_lock lock(_mutex);
+                const auto it = _paths.find(hash);
+                if (it != _paths.end()) {
+                    if (it->second != path) { Panic("PathId hash collision"); }
+                    return hash;
+                }
+            }
+
+            std::unique_lock lock(_mutex);
+            if (_paths.contains(hash)) { return hash; }
+            _paths.emplace(hash, Store(path));
+            return hash;
+        }
+
+        std::string_view Find(const u64 hash) {
+            std::shared_lock lock(_mutex);
+            const auto it = _paths.find(hash);
+            return it != _paths.end() ? it->second : std::string_view {};
+        }
+
+    private:
+        static constexpr size_t kBlockSize = 64 * 1024;
+
+        // Paths longer than kBlockSize get a block of their own, which is full right away
+        std::string_view Store(std::string_view path) {
+            if (path.size() > _blockCapacity - _blockUsed) {
+                _blockCapacity = std::max(kBlockSize, path.size());
+                _blocks.push_back(make_unique<char[]>(_blockCapacity));
+                _blockUsed = 0;
+            }
+            char* dest = _blocks.back().get() + _blockUsed;
+            std::memcpy(dest, path.data(), path.size());
+            _blockUsed += path.size();
+            return {dest, path.size()};
+        }
+
+        std::shared_mutex _mutex;
+        unordered_map<u64, std::string_view> _paths;
+        vector<unique_ptr<char[]>> _blocks;
+        size_t _blockUsed     = 0;
+        size_t _blockCapacity = 0;
+    };
+
+    PathId::PathId(std::string_view path) {
+        _hash = WithPathBuffer(std::max<size_t>(path.size(), 1), [&](std::span<char> buffer) {
+            const size_t length = NormalizePath(path, buffer);
+            return PathTable::Get().Intern({buffer.data(), length});
+        });
+    }
+
+    std::string_view PathId::Str() const {
+        if (!IsValid()) { return {}; }
+        return PathTable::Get().Find(_hash);
+    }
+
+    PathId PathId::Parent() const {
+        return *this / "..";
+    }
+
+    PathId PathId::operator/(std::string_view subPath) const {
+        const std::string_view path = Str();
+        const size_t size           = path.size() + 1 + subPath.size();
+        return WithPathBuffer(size, [&](std::span<char> buffer) {
+            std::memcpy(buffer.data(), path.data(), path.size());
+            buffer[path.size()] = '/';
+            std::memcpy(buffer.data() + path.size() + 1, subPath.data(), subPath.size());
+            return PathId({buffer.data(), size});
+        });
     }
 #pragma endregion
 
@@ -166,33 +1672,34 @@ namespace x::Filesystem {
 
     Path Path::Parent() const {
         const size_t lastSeparator = path.find_last_of(PATH_SEPARATOR);
-        if (lastSeparator == std::string::npos || lastSeparator == 0) {
-            return Path(std::to_string(PATH_SEPARATOR));
-        }
-        return Path(path.substr(0, lastSeparator));
+        if (lastSeparator == std::string::npos) { return {".", Normalized {}}; }
+        if (lastSeparator == 0) { return {str(1, PATH_SEPARATOR), Normalized {}}; }
+        return {path.substr(0, lastSeparator), Normalized {}};
     }
 
     bool Path::Exists() const {
-        struct stat info {};
-        return stat(path.c_str(), &info) == 0;
+        return Stat().HasValue();
     }
 
     bool Path::IsFile() const {
-        struct stat info {};
-        if (stat(path.c_str(), &info) != 0) {
-            std::perror(path.c_str());
-            return false;
-        }
-        return S_ISREG(info.st_mode);
+        const auto metadata = Stat();
+        return metadata && metadata->type == FileMetadata::Type::File;
     }
 
     bool Path::IsDirectory() const {
-        struct stat info {};
-        if (stat(path.c_str(), &info) != 0) {
-            std::perror(path.c_str());
-            return false;
+        const auto metadata = Stat();
+        return metadata && metadata->type == FileMetadata::Type::Directory;
+    }
+
+    FsResult<FileMetadata> Path::Stat() const {
+        if (auto& cache = MetadataCache::Get(); cache.IsEnabled()) {
+            const FileMetadata metadata = cache.Query(Id());
+            if (metadata.type == FileMetadata::Type::Missing) {
+                return Unexpected(FsError {ENOENT});
+            }
+            return metadata;
         }
-        return S_ISDIR(info.st_mode);
+        return StatPath(path.c_str());
     }
 
     bool Path::HasExtension() const {
@@ -207,16 +1714,26 @@ namespace x::Filesystem {
     }
 
     Path Path::ReplaceExtension(const str& ext) const {
-        if (!HasExtension()) return Path(path + "." + ext);
-        return Path(path.substr(0, path.find_last_of('.')) + "." + ext);
+        const size_t stem = HasExtension() ? path.find_last_of('.') : path.size();
+        str result;
+        result.reserve(stem + 1 + ext.size());
+        result.append(path, 0, stem).append(1, '.').append(ext);
+        return {std::move(result), Normalized {}};
     }
 
     Path Path::Join(const str& subPath) const {
-        return Path(Join(path, subPath));
+        if (subPath.empty()) { return *this; }
+        const size_t size = path.size() + 1 + subPath.size();
+        return WithPathBuffer(size, [&](std::span<char> buffer) {
+            std::memcpy(buffer.data(), path.data(), path.size());
+            buffer[path.size()] = PATH_SEPARATOR;
+            std::memcpy(buffer.data() + path.size() + 1, subPath.data(), subPath.size());
+            return Path(Normalize({buffer.data(), size}), Normalized {});
+        });
     }
 
     Path Path::operator/(const str& subPath) const {
-        return Path(Join(path, subPath));
+        return Join(subPath);
     }
 
     str Path::Str() const {
@@ -231,6 +1748,10 @@ namespace x::Filesystem {
         return path == other.path;
     }
 
+    PathId Path::Id() const {
+        return PathId(path);
+    }
+
     bool Path::Create() const {
         if (Exists()) return true;
 
@@ -244,6 +1765,7 @@ namespace x::Filesystem {
             if (errno != EEXIST) { return false; }
         }
 #endif
+        InvalidateCached(path);
         return true;
     }
 
@@ -260,38 +1782,288 @@ namespace x::Filesystem {
         return Create();
     }
 
-    str Path::Join(const str& lhs, const str& rhs) {
-        if (lhs.empty()) { return lhs; }
-        if (rhs.empty()) { return rhs; }
-        if (lhs.back() == PATH_SEPARATOR) return lhs + rhs;
-        return lhs + PATH_SEPARATOR + rhs;
+    str Path::Normalize(std::string_view rawPath) {
+        str result(std::max<size_t>(rawPath.size(), 1), '\0');
+        result.resize(NormalizePath(rawPath, result, PATH_SEPARATOR));
+        return result;
     }
+#pragma endregion
 
-    str Path::Normalize(const str& rawPath) {
-        str result;
-        std::vector<str> parts;
-        size_t start = 0;
-        while (start < rawPath.size()) {
-            size_t end = rawPath.find(PATH_SEPARATOR, start);
-            if (end == std::string::npos) { end = rawPath.size(); }
-            str part = rawPath.substr(start, end - start);
-            if (part == ".." && !parts.empty() && parts.back() != "..") {
-                parts.pop_back();
-            } else if (!part.empty() && part != ".") {
-                parts.push_back(part);
+#pragma region Directory
+    namespace {
+        struct FoundFile {
+            std::string_view path;
+            PathId id;
+        };
+
+        bool MatchesExtension(std::string_view name, std::span<const std::string_view> extensions) {
+            if (extensions.empty()) { return true; }
+            for (std::string_view extension : extensions) {
+                if (extension.starts_with('.')) { extension.remove_prefix(1); }
+                if (name.size() > extension.size() && name.ends_with(extension) &&
+                    name[name.size() - extension.size() - 1] == '.') {
+                    return true;
+                }
             }
-            start = end + 1;
+            return false;
         }
-        for (const auto& part : parts) {
-            result += PATH_SEPARATOR + part;
+
+        vector<PathId> SortedIds(vector<FoundFile>& files) {
+            std::ranges::sort(files, {}, &FoundFile::path);
+            vector<PathId> ids;
+            ids.reserve(files.size());
+            for (const auto& file : files) {
+                ids.push_back(file.id);
+            }
+            return ids;
         }
 
+        // Lists `dir` once. Matching files are appended to `files` and, if `subdirs` isn't null,
+        // directories to `subdirs`.
+        void ScanDirectory(const str& dir,
+                           std::span<const std::string_view> extensions,
+                           vector<FoundFile>& files,
+                           vector<str>* subdirs) {
+            str path = dir;  // Reused for every entry, so it only allocates while growing
+            auto found = [&](std::string_view name, const bool isDir) {
+                path.resize(dir.size());
+                path.append(1, '/').append(name);
+                if (isDir) {
+                    if (subdirs) { subdirs->push_back(path); }
+                } else if (MatchesExtension(name, extensions)) {
+                    const PathId id(path);
+                    files.push_back({id.Str(), id});
+                }
+            };
+
 #ifdef _WIN32
-        // Remove the first '/' if Windows path
-        result = result.substr(1, result.size() - 1);
+            WIN32_FIND_DATAA data;
+            const HANDLE find = FindFirstFileA((dir + "\\*").c_str(), &data);
+            if (find == INVALID_HANDLE_VALUE) { return; }
+            do {
+                const std::string_view name = data.cFileName;
+                if (name == "." || name == "..") { continue; }
+                const DWORD attributes = data.dwFileAttributes;
+                const bool isDir       = attributes & FILE_ATTRIBUTE_DIRECTORY;
+                // Don't follow junctions and directory symlinks
+                if (isDir && (attributes & FILE_ATTRIBUTE_REPARSE_POINT)) { continue; }
+                found(name, isDir);
+            } while (FindNextFileA(find, &data));
+            FindClose(find);
+#else
+            const int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (fd < 0) { return; }
+
+            // getdents64 returns a whole buffer of entries per syscall, and d_type saves a stat
+            // per entry on every filesystem we care about
+            alignas(dirent64) char buffer[32 * 1024];
+            for (;;) {
+                const long length = syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+                if (length <= 0) { break; }
+
+                for (long offset = 0; offset < length;) {
+                    const auto* entry = RCAST<const dirent64*>(buffer + offset);
+                    offset += entry->d_reclen;
+
+                    const std::string_view name = entry->d_name;
+                    if (name == "." || name == "..") { continue; }
+
+                    u8 type = entry->d_type;
+                    struct stat info {};
+                    if (type == DT_UNKNOWN &&
+                        fstatat(fd, entry->d_name, &info, AT_SYMLINK_NOFOLLOW) == 0) {
+                        type = S_ISDIR(info.st_mode)   ? DT_DIR
+                               : S_ISREG(info.st_mode) ? DT_REG
+                               : S_ISLNK(info.st_mode) ? DT_LNK
+                                                       : DT_UNKNOWN;
+                    }
+                    if (type == DT_LNK) {
+                        // Symlinked files count, symlinked directories aren't followed
+                        const bool isFile = fstatat(fd, entry->d_name, &info, 0) == 0 &&
+                                            S_ISREG(info.st_mode);
+                        type = isFile ? DT_REG : DT_UNKNOWN;
+                    }
+
+                    if (type == DT_DIR || type == DT_REG) { found(name, type == DT_DIR); }
+                }
+            }
+            close(fd);
 #endif
+        }
+    }  // namespace
+
+    vector<PathId> Directory::Enumerate(std::string_view path,
+                                        std::span<const std::string_view> extensions) {
+        vector<FoundFile> files;
+        ScanDirectory(str(path), extensions, files, None);
+        return SortedIds(files);
+    }
+
+    vector<PathId> Directory::Walk(std::string_view root,
+                                   std::span<const std::string_view> extensions) {
+        // Scanners pop directories off a shared stack and push the subdirectories they find. The
+        // walk is done once the stack is empty and nobody is scanning anymore. Helpers that only
+        // get to run after that find nothing to do, and the state outlives them.
+        struct Walker : std::enable_shared_from_this<Walker> {
+            std::mutex mutex;
+            std::condition_variable cv;
+            vector<str> pending;
+            vector<FoundFile> files;
+            vector<str> extensionStorage;
+            vector<std::string_view> extensions;
+            u32 scanning    = 0;
+            u32 helpersLeft = 0;
+
+            void Run() {
+                vector<FoundFile> found;
+                vector<str> subdirs;
+                std::unique_lock lock(mutex);
+                for (;;) {
+                    cv.wait(lock, [&] { return !pending.empty() || scanning == 0; });
+                    if (pending.empty()) { return; }
+
+                    const str dir = std::move(pending.back());
+                    pending.pop_back();
+                    scanning++;
+                    lock.unlock();
+
+                    ScanDirectory(dir, extensions, found, &subdirs);
+
+                    lock.lock();
+                    scanning--;
+                    files.insert(files.end(), found.begin(), found.end());
+                    std::ranges::move(subdirs, std::back_inserter(pending));
+                    found.clear();
+                    subdirs.clear();
+                    cv.notify_all();
+
+                    // Bring in helpers once there's more than one directory to go around
+                    if (helpersLeft > 0 && pending.size() > 1) {
+                        const u32 spawn = std::min<u32>(helpersLeft, CAST<u32>(pending.size()) - 1);
+                        helpersLeft -= spawn;
+                        lock.unlock();
+                        for (u32 i = 0; i < spawn; i++) {
+                            auto helper = [self = shared_from_this()] { self->Run(); };
+                            if (!IoPool::Get().TrySubmit(helper)) { break; }
+                        }
+                        lock.lock();
+                    }
+                }
+            }
+        };
+
+        auto walker = make_shared<Walker>();
+        walker->extensionStorage.assign(extensions.begin(), extensions.end());
+        walker->extensions.assign(walker->extensionStorage.begin(),
+                                  walker->extensionStorage.end());
+        walker->pending.emplace_back(root);
+        walker->helpersLeft = IoPool::Get().GetWorkerCount();
+        walker->Run();
+
+        std::lock_guard lock(walker->mutex);
+        return SortedIds(walker->files);
+    }
+#pragma endregion
+
+#pragma region MetadataCache
+    MetadataCache& MetadataCache::Get() {
+        static MetadataCache cache;
+        return cache;
+    }
+
+    void MetadataCache::SetEnabled(const bool enabled) {
+        _enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool MetadataCache::IsEnabled() const {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    FileMetadata MetadataCache::Query(const PathId path) {
+        // Read before the stat, so a bump that lands while we're stat()ing leaves the new entry
+        // stale instead of letting it pass for fresh
+        const u64 generation = _generation.load(std::memory_order_acquire);
+        u64 epoch;
+        {
+            std::shared_lock lock(_mutex);
+            const auto it = _entries.find(path);
+            if (it != _entries.end() && it->second.generation == generation) {
+                _hits.fetch_add(1, std::memory_order_relaxed);
+                return it->second.metadata;
+            }
+            epoch = _epoch;
+        }
+        _misses.fetch_add(1, std::memory_order_relaxed);
+
+        const std::string_view text = path.Str();
+        const FileMetadata metadata = WithPathBuffer(text.size() + 1, [&](std::span<char> buffer) {
+            std::memcpy(buffer.data(), text.data(), text.size());
+            buffer[text.size()] = '\0';
+            return StatPath(buffer.data()).ValueOr(FileMetadata {});
+        });
+
+        // An Invalidate() since the lookup may have been for this path and the stat may predate
+        // it, so don't cache a result that could already be stale
+        std::unique_lock lock(_mutex);
+        if (_epoch == epoch) { _entries.insert_or_assign(path, Entry {metadata, generation}); }
+        return metadata;
+    }
+
+    void MetadataCache::Invalidate(const PathId path) {
+        _invalidations.fetch_add(1, std::memory_order_relaxed);
+        std::unique_lock lock(_mutex);
+        _epoch++;
+        _entries.erase(path);
+    }
+
+    void MetadataCache::Invalidate(std::span<const FileChange> changes) {
+        if (changes.empty()) { return; }
+
+        // The watcher dropped events, whatever is cached may be stale
+        if (std::ranges::any_of(changes, [](const FileChange& change) {
+                return change.kind == FileChange::Kind::Overflow;
+            })) {
+            BumpGeneration();
+            return;
+        }
+
+        // Creating and removing files also changes their directory's mtime
+        vector<PathId> paths;
+        paths.reserve(changes.size() * 2);
+        for (const auto& change : changes) {
+            paths.emplace_back(change.path);
+            paths.push_back(paths.back().Parent());
+        }
+
+        _invalidations.fetch_add(changes.size(), std::memory_order_relaxed);
+        std::unique_lock lock(_mutex);
+        _epoch++;
+        for (const PathId& path : paths) {
+            _entries.erase(path);
+        }
+    }
+
+    void MetadataCache::BumpGeneration() {
+        _invalidations.fetch_add(1, std::memory_order_relaxed);
+        _generation.fetch_add(1, std::memory_order_release);
+    }
+
+    MetadataCacheStats MetadataCache::GetStats() const {
+        MetadataCacheStats stats {};
+        stats.hits          = _hits.load(std::memory_order_relaxed);
+        stats.misses        = _misses.load(std::memory_order_relaxed);
+        stats.invalidations = _invalidations.load(std::memory_order_relaxed);
+        stats.generation    = _generation.load(std::memory_order_relaxed);
+
+        std::shared_lock lock(_mutex);
+        stats.entries = _entries.size();
+        return stats;
+    }
 
-        return result.empty() ? str(1, PATH_SEPARATOR) : result;
+    void MetadataCache::ResetStats() {
+        _hits.store(0, std::memory_order_relaxed);
+        _misses.store(0, std::memory_order_relaxed);
+        _invalidations.store(0, std::memory_order_relaxed);
     }
 #pragma endregion
 }  // namespace x::Filesystem
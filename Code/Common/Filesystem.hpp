@@ -5,11 +5,25 @@
 #pragma once
 
 #include "Types.hpp"
+#include "BufferPool.hpp"
+#include "Endian.hpp"
+#include "FileWatcher.hpp"
+#include "IoPool.hpp"
+#include "IoUring.hpp"
+#include "Result.hpp"
+#include <cerrno>
 #include <fstream>
 #include <vector>
 #include <algorithm>
 #include <stdexcept>
+#include <condition_variable>
 #include <future>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <thread>
 #ifdef _WIN32
     #include <direct.h>
     #define getcwd _getcwd
@@ -21,66 +35,639 @@
 
 namespace x {
     namespace Filesystem {
+        /// Why a filesystem call failed, as the errno it failed with.
+        struct FsError {
+            i32 code = 0;
+
+            [[nodiscard]] bool IsNotFound() const {
+                return code == ENOENT;
+            }
+
+            [[nodiscard]] str Message() const {
+                return std::generic_category().message(code);
+            }
+        };
+
+        template<typename T>
+        using FsResult = Result<T, FsError>;
+
+        struct PrefetchRange {
+            str path;
+            u64 offset  = 0;
+            size_t size = 0;  // 0 covers the rest of the file
+        };
+
+        struct PrefetchStats {
+            u64 requested;       // Ranges passed to Prefetch()
+            u64 dropped;         // Ranges skipped because the IoPool queue was full
+            u64 completed;       // Ranges the kernel was asked to read ahead
+            u64 failed;          // Ranges whose file couldn't be opened
+            u64 bytes;           // Bytes covered by completed ranges
+            u64 evicted;         // Ranges passed to Evict()
+            u64 readBlockCalls;  // FileReader::ReadBlock calls, prefetched or not
+            u64 readBlockNs;     // Time spent in them, which is what prefetching should cut
+        };
+
+        static constexpr std::string_view kUtf8Bom = "\xEF\xBB\xBF";
+
+        /// Drops a leading UTF-8 byte order mark, which some editors write and no parser expects.
+        constexpr std::string_view StripUtf8Bom(std::string_view text) {
+            return text.starts_with(kUtf8Bom) ? text.substr(kUtf8Bom.size()) : text;
+        }
+
+        class MappedText;
+
+        /// The Try* functions report why they failed, so a loader can issue one read and branch
+        /// on the error instead of checking Path::Exists() first. The plain versions wrap them
+        /// and return an empty result on any failure.
+        ///
+        /// Text reads query the size once and read straight into a single allocation. They strip
+        /// a leading UTF-8 BOM. Files that report a size of 0 (pipes, /proc) are read until EOF.
         class FileReader {
         public:
             static std::vector<u8> ReadAllBytes(const str& path);
             static str ReadAllText(const str& path);
             static std::vector<str> ReadAllLines(const str& path);
             static std::vector<u8> ReadBlock(const str& path, size_t size, u64 offset = 0);
+
+            static FsResult<std::vector<u8>> TryReadAllBytes(const str& path);
+            static FsResult<str> TryReadAllText(const str& path);
+            /// Zero-copy alternative to ReadAllText() for text that's only parsed once, like shader
+            /// sources and JSON: maps the file and returns a view of it.
+            static FsResult<MappedText> MapAllText(const str& path);
+            /// Fails with EINVAL if [offset, offset + size) isn't inside the file.
+            static FsResult<std::vector<u8>>
+            TryReadBlock(const str& path, size_t size, u64 offset = 0);
+            /// Fails with EISDIR for directories.
+            static FsResult<size_t> TryQueryFileSize(const str& path);
+
+            /// Reads up to `dest.size()` bytes at `offset` into caller-owned memory. Returns the
+            /// byte count, which is only short at the end of the file.
+            static FsResult<size_t> ReadBlock(const str& path, std::span<u8> dest, u64 offset = 0);
+            /// Reads the whole file into `out`, reusing its capacity. Returns the file size, so a
+            /// reader that keeps `out` around stops allocating once it's big enough.
+            static FsResult<size_t> ReadAllBytes(const str& path, std::vector<u8>& out);
+            static FsResult<size_t> ReadAllText(const str& path, str& out);
+
+            /// Scatter read: fills `buffers` in order from the bytes starting at `offset`, with a
+            /// single preadv when the list is short. Returns false unless every buffer was filled.
+            static bool
+            ReadBlock(const str& path, std::span<const std::span<u8>> buffers, u64 offset = 0);
+            /// Blocking pread of every request into its own buffer. Returns true if all of them
+            /// were read in full, per-request results are written back into `requests`.
+            static bool ReadBlocks(std::span<ReadRequest> requests);
             static size_t QueryFileSize(const str& path);
+
+            /// Asks the kernel to read [offset, offset + size) into the page cache from an IoPool
+            /// worker, so a later ReadBlock is served from memory. Never blocks: when the pool's
+            /// queue is full the hint is dropped. Only implemented on Linux, a no-op elsewhere.
+            static void Prefetch(const str& path, u64 offset = 0, size_t size = 0);
+            /// Prefetches every range with a single pool job, opening each file once.
+            static void Prefetch(std::span<const PrefetchRange> ranges);
+            /// Drops the clean cached pages of a range we're done with (POSIX_FADV_DONTNEED), so
+            /// they stop competing with the assets that are still needed.
+            static void Evict(const str& path, u64 offset = 0, size_t size = 0);
+            static void Evict(std::span<const PrefetchRange> ranges);
+
+            [[nodiscard]] static PrefetchStats GetPrefetchStats();
+            static void ResetPrefetchStats();
+        };
+
+        /// Read-only, zero-copy view of a file's contents backed by mmap (MapViewOfFile on
+        /// Windows). The mapping lives as long as the MappedFile, so spans returned by Data() or
+        /// Slice() must not outlive it.
+        class MappedFile {
+        public:
+            enum class AccessHint : u8 {
+                Normal,
+                Sequential,
+                Random,
+                WillNeed,
+                DontNeed,
+            };
+
+            MappedFile() = default;
+            explicit MappedFile(const str& path,
+                                AccessHint hint = AccessHint::Normal,
+                                bool hugePages  = false);
+            ~MappedFile();
+
+            MappedFile(const MappedFile&)            = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            MappedFile(MappedFile&& other) noexcept;
+            MappedFile& operator=(MappedFile&& other) noexcept;
+
+            /// Maps `path` read-only. `hugePages` first tries a MAP_HUGETLB mapping (hugetlbfs
+            /// only) and otherwise asks for transparent huge pages via madvise.
+            bool
+            Open(const str& path, AccessHint hint = AccessHint::Normal, bool hugePages = false);
+            void Close();
+
+            /// Applies an access hint to the byte range [offset, offset + size). A size of 0
+            /// applies the hint to the rest of the mapping.
+            void Advise(AccessHint hint, u64 offset = 0, size_t size = 0) const;
+
+            [[nodiscard]] bool IsOpen() const;
+            [[nodiscard]] size_t Size() const;
+            [[nodiscard]] std::span<const u8> Data() const;
+            [[nodiscard]] std::span<const u8> Slice(u64 offset, size_t size) const;
+            [[nodiscard]] std::string_view Text() const;
+
+        private:
+            u8* _data    = None;
+            size_t _size = 0;
+            bool _open   = false;
+#ifdef _WIN32
+            void* _file    = None;
+            void* _mapping = None;
+#endif
+        };
+
+        /// A mapped text file, viewed without its UTF-8 BOM. The view is only valid while the
+        /// MappedText is alive, moving it is fine.
+        class MappedText {
+        public:
+            MappedText() = default;
+            explicit MappedText(MappedFile file)
+                : _file(std::move(file)), _text(StripUtf8Bom(_file.Text())) {}
+
+            [[nodiscard]] bool IsOpen() const {
+                return _file.IsOpen();
+            }
+            [[nodiscard]] std::string_view Text() const {
+                return _text;
+            }
+
+        private:
+            MappedFile _file;
+            std::string_view _text;
+        };
+
+        /// Splits text into lines without allocating or copying. Lines end at '\n', a trailing '\r'
+        /// is dropped so CRLF files read the same as LF ones. Like std::getline, a final empty
+        /// line after the last newline is not produced.
+        class LineRange {
+        public:
+            class Iterator {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type        = std::string_view;
+                using difference_type   = std::ptrdiff_t;
+                using pointer           = const std::string_view*;
+                using reference         = const std::string_view&;
+
+                Iterator() = default;
+                Iterator(const char* begin, const char* end);
+
+                reference operator*() const {
+                    return _line;
+                }
+                pointer operator->() const {
+                    return &_line;
+                }
+                Iterator& operator++();
+                Iterator operator++(int);
+                bool operator==(const Iterator& other) const {
+                    return _next == other._next;
+                }
+
+            private:
+                const char* _next = None;  // Start of the line after _line, null once exhausted
+                const char* _end  = None;
+                std::string_view _line;
+            };
+
+            LineRange() = default;
+            explicit LineRange(std::string_view text) : _text(text) {}
+
+            [[nodiscard]] Iterator begin() const;
+            [[nodiscard]] Iterator end() const;
+
+        private:
+            std::string_view _text;
+        };
+
+        /// Maps a text file and iterates its lines as views into the mapping, skipping a UTF-8 BOM.
+        /// The views are only valid while the FileLines object is alive. Files that report a size
+        /// of 0, like pipes or the ones in /proc, are read into memory instead.
+        class FileLines {
+        public:
+            explicit FileLines(const str& path)
+                : _file(path, MappedFile::AccessHint::Sequential), _open(_file.IsOpen()),
+                  _lines(StripUtf8Bom(_file.Text())) {
+                if (_file.Size() > 0) { return; }
+                if (auto text = FileReader::TryReadAllText(path)) {
+                    _text  = std::move(*text);
+                    _open  = true;
+                    _lines = LineRange(_text);
+                }
+            }
+
+            [[nodiscard]] bool IsOpen() const {
+                return _open;
+            }
+            [[nodiscard]] LineRange::Iterator begin() const {
+                return _lines.begin();
+            }
+            [[nodiscard]] LineRange::Iterator end() const {
+                return _lines.end();
+            }
+
+        private:
+            MappedFile _file;
+            str _text;  // Only used when the file couldn't be mapped
+            bool _open;
+            LineRange _lines;
+        };
+
+        enum class WriteMode : u8 {
+            Truncate,  // Rewrite the file in place, a crash mid-write leaves it corrupt
+            Atomic,    // Write a temp file with the target's mode, fdatasync it and rename it over
         };
 
         class FileWriter {
         public:
-            static bool WriteAllBytes(const str& path, const std::vector<u8>& data);
-            static bool WriteAllText(const str& path, const str& text);
-            static bool WriteAllLines(const str& path, const std::vector<str>& lines);
+            static bool WriteAllBytes(const str& path,
+                                      const std::vector<u8>& data,
+                                      WriteMode mode = WriteMode::Truncate);
+            /// Gather write of `buffers` back to back as the whole file, e.g. a header, a table
+            /// and a payload that live in separate allocations, without concatenating them.
+            static bool WriteAllBytes(const str& path,
+                                      std::span<const std::span<const u8>> buffers,
+                                      WriteMode mode = WriteMode::Truncate);
+            static bool
+            WriteAllText(const str& path, const str& text, WriteMode mode = WriteMode::Truncate);
+            static bool WriteAllLines(const str& path,
+                                      const std::vector<str>& lines,
+                                      WriteMode mode = WriteMode::Truncate);
+            /// Writes `data` at `offset`. Both WriteBlock overloads create the file if it's missing
+            /// and never truncate it, a gap before `offset` reads back as zeros.
             static bool WriteBlock(const str& path, const std::vector<u8>& data, u64 offset = 0);
+            /// Gather write of `buffers` back to back starting at `offset`, with a single pwritev
+            /// when the list is short.
+            static bool WriteBlock(const str& path,
+                                   std::span<const std::span<const u8>> buffers,
+                                   u64 offset = 0);
+
+            static FsResult<void> TryWriteAllBytes(const str& path,
+                                                   std::span<const std::span<const u8>> buffers,
+                                                   WriteMode mode = WriteMode::Truncate);
+            static FsResult<void> TryWriteBlock(const str& path,
+                                                std::span<const std::span<const u8>> buffers,
+                                                u64 offset = 0);
+
+        private:
+            static FsResult<void> WriteAtomic(const str& path,
+                                              std::span<const std::span<const u8>> buffers);
+        };
+
+        struct GroupCommitConfig {
+            u32 maxBatch   = 256;   // Writes committed per sync at most
+            u32 maxDelayUs = 2000;  // How long the first write of a batch waits for company
         };
 
+        /// Durable atomic writes for callers that save lots of small files, like caches and
+        /// configs. Writes are gathered on a background thread and committed in batches: every
+        /// file in the batch goes to a temp file, the whole batch is synced together (one syncfs
+        /// per filesystem on Linux), and then each temp file is renamed over its target. Futures
+        /// resolve once the write is on disk. Writing the same path twice in one batch only
+        /// stores the last data.
+        class GroupCommitWriter {
+        public:
+            explicit GroupCommitWriter(const GroupCommitConfig& config = {});
+            ~GroupCommitWriter();
+
+            GroupCommitWriter(const GroupCommitWriter&)            = delete;
+            GroupCommitWriter& operator=(const GroupCommitWriter&) = delete;
+
+            std::future<bool> Write(const str& path, std::vector<u8> data);
+            /// Blocks until every write submitted so far is committed.
+            void Flush();
+
+        private:
+            struct Pending {
+                str path;
+                std::vector<u8> data;
+                std::promise<bool> promise;
+            };
+
+            void CommitLoop();
+            static void Commit(std::vector<Pending>& batch);
+
+            GroupCommitConfig _config;
+            std::mutex _mutex;
+            std::condition_variable _cv;
+            std::condition_variable _idleCv;
+            std::vector<Pending> _queue;
+            bool _committing = false;
+            bool _flushing   = false;
+            bool _stop       = false;
+            std::thread _thread;
+        };
+
+        /// Async operations run on the shared IoPool. Cancelling a token before the read is picked
+        /// up by a worker makes the returned future throw std::future_error on get().
         class AsyncFileReader {
         public:
-            static std::future<std::vector<u8>> ReadAllBytes(const str& path);
-            static std::future<str> ReadAllText(const str& path);
-            static std::future<std::vector<str>> ReadAllLines(const str& path);
+            enum class BatchBackend : u8 {
+                Auto,        // io_uring when the kernel supports it, thread pool otherwise
+                ThreadPool,  // Always run batches as pread jobs on the IoPool
+            };
+
+            static std::future<std::vector<u8>>
+            ReadAllBytes(const str& path,
+                         IoPriority priority             = IoPriority::Background,
+                         const CancellationToken& cancel = {});
+            static std::future<str> ReadAllText(const str& path,
+                                                IoPriority priority = IoPriority::Background,
+                                                const CancellationToken& cancel = {});
+            static std::future<std::vector<str>>
+            ReadAllLines(const str& path,
+                         IoPriority priority             = IoPriority::Background,
+                         const CancellationToken& cancel = {});
             static std::future<std::vector<u8>>
-            ReadBlock(const str& path, size_t size, u64 offset = 0);
+            ReadBlock(const str& path,
+                      size_t size,
+                      u64 offset                      = 0,
+                      IoPriority priority             = IoPriority::Background,
+                      const CancellationToken& cancel = {});
+            /// Reads into caller-owned memory, which must stay alive until the future is ready.
+            /// The result is the same as FileReader::ReadBlock's.
+            static std::future<FsResult<size_t>>
+            ReadBlock(const str& path,
+                      std::span<u8> dest,
+                      u64 offset                      = 0,
+                      IoPriority priority             = IoPriority::Background,
+                      const CancellationToken& cancel = {});
+            /// Reads into a buffer from `pool`, the future carries the buffer and the result of
+            /// the read. Dropping the buffer hands it back to the pool.
+            static std::future<std::pair<PooledBuffer, FsResult<size_t>>>
+            ReadBlock(const str& path,
+                      BufferPool& pool,
+                      u64 offset                      = 0,
+                      IoPriority priority             = IoPriority::Background,
+                      const CancellationToken& cancel = {});
+
+            /// Reads a batch of blocks straight into caller-owned buffers. With io_uring the whole
+            /// batch is one submission and no thread is tied up per read; otherwise it runs as a
+            /// single IoPool job. `priority` and `cancel` only apply to the thread pool path.
+            static std::future<bool> ReadBlocks(std::span<ReadRequest> requests,
+                                                bool directIo                   = false,
+                                                IoPriority priority = IoPriority::Streaming,
+                                                const CancellationToken& cancel = {});
+            /// Registers fixed buffers with the shared ring so requests with a `bufferIndex` skip
+            /// the per-read page pinning. Call once at startup, before any batch is in flight.
+            static bool RegisterBuffers(std::span<const std::span<u8>> buffers);
+            static void SetBatchBackend(BatchBackend backend);
+            [[nodiscard]] static bool IsUsingIoUring();
 
         private:
             template<typename Func>
-            static auto runAsync(Func&& func) -> std::future<decltype(func())> {
-                using ReturnType = decltype(func());
-                auto task =
-                  std::make_shared<std::packaged_task<ReturnType()>>(std::forward<Func>(func));
-                std::future<ReturnType> future = task->get_future();
-                std::thread([task]() { (*task)(); }).detach();
-                return future;
+            static auto runAsync(Func&& func, IoPriority priority, const CancellationToken& cancel)
+              -> std::future<decltype(func())> {
+                return IoPool::Get().Submit(std::forward<Func>(func), priority, cancel);
             }
         };
 
         class AsyncFileWriter {
         public:
-            static std::future<bool> WriteAllBytes(const str& path, const std::vector<u8>& data);
-            static std::future<bool> WriteAllText(const str& path, const str& text);
-            static std::future<bool> WriteAllLines(const str& path, const std::vector<str>& lines);
-            static std::future<bool>
-            WriteBlock(const str& path, const std::vector<u8>& data, u64 offset = 0);
+            static std::future<bool> WriteAllBytes(const str& path,
+                                                   const std::vector<u8>& data,
+                                                   IoPriority priority = IoPriority::Background,
+                                                   const CancellationToken& cancel = {});
+            static std::future<bool> WriteAllText(const str& path,
+                                                  const str& text,
+                                                  IoPriority priority = IoPriority::Background,
+                                                  const CancellationToken& cancel = {});
+            static std::future<bool> WriteAllLines(const str& path,
+                                                   const std::vector<str>& lines,
+                                                   IoPriority priority = IoPriority::Background,
+                                                   const CancellationToken& cancel = {});
+            static std::future<bool> WriteBlock(const str& path,
+                                                const std::vector<u8>& data,
+                                                u64 offset                      = 0,
+                                                IoPriority priority = IoPriority::Background,
+                                                const CancellationToken& cancel = {});
 
         private:
             template<typename Func>
-            static auto runAsync(Func&& func) -> std::future<decltype(func())> {
-                using ReturnType = decltype(func());
-                auto task =
-                  std::make_shared<std::packaged_task<ReturnType()>>(std::forward<Func>(func));
-                std::future<ReturnType> future = task->get_future();
-                std::thread([task]() { (*task)(); }).detach();
-                return future;
+            static auto runAsync(Func&& func, IoPriority priority, const CancellationToken& cancel)
+              -> std::future<decltype(func())> {
+                return IoPool::Get().Submit(std::forward<Func>(func), priority, cancel);
             }
         };
 
-        // class StreamReader {};
-        //
-        // class StreamWriter {};
+        /// Coroutine counterparts of AsyncFileReader. Each call returns an awaitable that runs the
+        /// read on the IoPool and resumes the awaiting coroutine on `executor`, e.g. a
+        /// FrameExecutor to continue on the main thread. The default continues on the I/O worker
+        /// that did the read. Results are the same as FileReader's Try* functions.
+        class AwaitableFileReader {
+        public:
+            static IoAwaitable<FsResult<std::vector<u8>>>
+            ReadAllBytes(const str& path,
+                         Executor& executor  = InlineExecutor::Get(),
+                         IoPriority priority = IoPriority::Background);
+            static IoAwaitable<FsResult<str>>
+            ReadAllText(const str& path,
+                        Executor& executor  = InlineExecutor::Get(),
+                        IoPriority priority = IoPriority::Background);
+            static IoAwaitable<std::vector<str>>
+            ReadAllLines(const str& path,
+                         Executor& executor  = InlineExecutor::Get(),
+                         IoPriority priority = IoPriority::Background);
+            static IoAwaitable<FsResult<std::vector<u8>>>
+            ReadBlock(const str& path,
+                      size_t size,
+                      u64 offset          = 0,
+                      Executor& executor  = InlineExecutor::Get(),
+                      IoPriority priority = IoPriority::Background);
+            /// Reads into caller-owned memory, which must stay alive until the co_await returns.
+            static IoAwaitable<FsResult<size_t>>
+            ReadBlock(const str& path,
+                      std::span<u8> dest,
+                      u64 offset          = 0,
+                      Executor& executor  = InlineExecutor::Get(),
+                      IoPriority priority = IoPriority::Background);
+        };
+
+        /// Coroutine counterparts of AsyncFileWriter, see AwaitableFileReader. The data is moved
+        /// into the job, so pass it with std::move when the caller doesn't need it anymore.
+        class AwaitableFileWriter {
+        public:
+            static IoAwaitable<FsResult<void>>
+            WriteAllBytes(const str& path,
+                          std::vector<u8> data,
+                          WriteMode mode      = WriteMode::Truncate,
+                          Executor& executor  = InlineExecutor::Get(),
+                          IoPriority priority = IoPriority::Background);
+            static IoAwaitable<FsResult<void>>
+            WriteAllText(const str& path,
+                         str text,
+                         WriteMode mode      = WriteMode::Truncate,
+                         Executor& executor  = InlineExecutor::Get(),
+                         IoPriority priority = IoPriority::Background);
+            static IoAwaitable<FsResult<void>>
+            WriteAllLines(const str& path,
+                          std::vector<str> lines,
+                          WriteMode mode      = WriteMode::Truncate,
+                          Executor& executor  = InlineExecutor::Get(),
+                          IoPriority priority = IoPriority::Background);
+            static IoAwaitable<FsResult<void>>
+            WriteBlock(const str& path,
+                       std::vector<u8> data,
+                       u64 offset          = 0,
+                       Executor& executor  = InlineExecutor::Get(),
+                       IoPriority priority = IoPriority::Background);
+        };
+
+        /// Sequential binary reader that pulls the file through one fixed-size buffer, so parsing a
+        /// large file only ever costs `bufferSize` bytes of memory. Typed reads are little-endian.
+        class StreamReader {
+        public:
+            static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
+            explicit StreamReader(const str& path, size_t bufferSize = kDefaultBufferSize);
+
+            StreamReader(const StreamReader&)            = delete;
+            StreamReader& operator=(const StreamReader&) = delete;
+
+            StreamReader(StreamReader&&) noexcept            = default;
+            StreamReader& operator=(StreamReader&&) noexcept = default;
+
+            /// Reads up to `dest.size()` bytes and returns how many were read. Reads larger than
+            /// the internal buffer go straight into `dest`.
+            size_t Read(std::span<u8> dest);
+
+            template<Trivial T>
+            std::optional<T> Read() {
+                T value;
+                if (_bufferLen - _bufferPos >= sizeof(T)) {
+                    std::memcpy(&value, _buffer.data() + _bufferPos, sizeof(T));
+                    _bufferPos += sizeof(T);
+                } else if (Read(std::span(RCAST<u8*>(&value), sizeof(T))) != sizeof(T)) {
+                    return Empty;
+                }
+                return LittleEndian(value);
+            }
+
+            bool Seek(u64 offset);
+            bool Skip(u64 count);
+            [[nodiscard]] u64 Tell() const;
+            [[nodiscard]] u64 Size() const;
+            [[nodiscard]] bool IsOpen() const;
+            [[nodiscard]] bool IsEof() const;
+
+        private:
+            bool Refill();
+
+            std::ifstream _file;
+            std::vector<u8> _buffer;
+            size_t _bufferPos = 0;  // Read cursor inside the buffer
+            size_t _bufferLen = 0;  // Valid bytes in the buffer
+            u64 _bufferStart  = 0;  // File offset of the first buffered byte
+            u64 _size         = 0;
+        };
+
+        /// Sequential binary writer that batches small writes into one fixed-size buffer. Typed
+        /// writes are little-endian. Buffered data is flushed on Seek() and on destruction.
+        class StreamWriter {
+        public:
+            static constexpr size_t kDefaultBufferSize = 64 * 1024;
+
+            explicit StreamWriter(const str& path,
+                                  bool append       = false,
+                                  size_t bufferSize = kDefaultBufferSize);
+            ~StreamWriter();
+
+            StreamWriter(const StreamWriter&)            = delete;
+            StreamWriter& operator=(const StreamWriter&) = delete;
+
+            StreamWriter(StreamWriter&& other) noexcept;
+            StreamWriter& operator=(StreamWriter&& other) noexcept;
+
+            bool Write(std::span<const u8> data);
+
+            template<Trivial T>
+            bool Write(T value) {
+                if (!_file.is_open()) { return false; }
+                value = LittleEndian(value);
+                if (_buffer.size() - _bufferLen >= sizeof(T)) {
+                    std::memcpy(_buffer.data() + _bufferLen, &value, sizeof(T));
+                    _bufferLen += sizeof(T);
+                    return true;
+                }
+                return Write(std::span(RCAST<const u8*>(&value), sizeof(T)));
+            }
+
+            bool Flush();
+            bool Seek(u64 offset);
+            [[nodiscard]] u64 Tell() const;
+            [[nodiscard]] bool IsOpen() const;
+
+        private:
+            std::ofstream _file;
+            std::vector<u8> _buffer;
+            size_t _bufferLen = 0;
+            u64 _bufferStart  = 0;  // File offset the buffer will be written to
+        };
+
+        /// Longest path the stack-buffer fast paths handle, longer ones fall back to the heap.
+        static constexpr size_t kMaxPathLength = 1024;
+
+        /// Collapses repeated separators, "." and ".." components of `path` into `out` without
+        /// allocating, and returns the normalized length, or 0 if `out` is shorter than `path`.
+        /// Both '/' and PATH_SEPARATOR are accepted and written as `separator`. Leading ".."
+        /// components of relative paths are kept, and an empty result becomes ".". The output is
+        /// never longer than the input, so `out` may alias `path`.
+        size_t NormalizePath(std::string_view path, std::span<char> out, char separator = '/');
+
+        /// A normalized, '/' separated path interned in a process-wide string table and
+        /// identified by the FNV-1a hash of its text, the same hash archives index entries by.
+        /// Equality, hashing and copies only touch the 64-bit id, so maps keyed by PathId never
+        /// allocate or re-normalize. Constructing one only allocates the first time a path is seen.
+        class PathId {
+        public:
+            constexpr PathId() = default;
+            explicit PathId(std::string_view path);
+
+            [[nodiscard]] bool IsValid() const {
+                return _hash != 0;
+            }
+
+            [[nodiscard]] u64 Value() const {
+                return _hash;
+            }
+
+            /// The interned normalized text, valid for the rest of the process.
+            [[nodiscard]] std::string_view Str() const;
+            [[nodiscard]] PathId Parent() const;
+            [[nodiscard]] PathId operator/(std::string_view subPath) const;
+
+            bool operator==(const PathId& other) const = default;
+
+            struct Hash {
+                size_t operator()(const PathId& id) const noexcept {
+                    return id.Value();
+                }
+            };
+
+        private:
+            u64 _hash = 0;
+        };
+
+        struct FileMetadata {
+            enum class Type : u8 {
+                Missing,
+                File,
+                Directory,
+                Other,
+            };
+
+            Type type   = Type::Missing;
+            u64 size    = 0;
+            i64 mtimeNs = 0;  // Last modification, nanoseconds since the Unix epoch
+        };
 
         class Path {
         public:
@@ -91,6 +678,9 @@ namespace x {
             [[nodiscard]] bool Exists() const;
             [[nodiscard]] bool IsFile() const;
             [[nodiscard]] bool IsDirectory() const;
+            /// stat() with the reason it failed. Goes through the MetadataCache when it's enabled,
+            /// which only remembers that a path is missing, so cached failures report ENOENT.
+            [[nodiscard]] FsResult<FileMetadata> Stat() const;
             [[nodiscard]] bool HasExtension() const;
             [[nodiscard]] str Extension() const;
             [[nodiscard]] Path ReplaceExtension(const str& ext) const;
@@ -100,13 +690,89 @@ namespace x {
             [[nodiscard]] const char* CStr() const;
             [[nodiscard]] bool operator==(const Path& other) const;
 
+            /// Interns this path, see PathId.
+            [[nodiscard]] PathId Id() const;
+
             bool Create() const;
             bool CreateAll() const;
 
         private:
+            // Takes an already normalized path
+            struct Normalized {};
+            Path(str path, Normalized) : path(std::move(path)) {}
+
             str path;
-            static str Join(const str& lhs, const str& rhs);
-            static str Normalize(const str& rawPath);
+            static str Normalize(std::string_view rawPath);
+        };
+
+        /// Directory listing. Only regular files are returned (symlinked files included, symlinked
+        /// directories aren't followed), as a flat vector of interned paths sorted by their text.
+        /// `extensions` keeps only files with one of the given extensions, written without the
+        /// dot like Path::Extension() returns them; empty keeps everything.
+        class Directory {
+        public:
+            static vector<PathId> Enumerate(std::string_view path,
+                                            std::span<const std::string_view> extensions = {});
+
+            /// Recursive Enumerate(). Subdirectories are scanned in parallel on the IoPool, with
+            /// the calling thread taking part, so it's fine to call from inside a pool job.
+            static vector<PathId> Walk(std::string_view root,
+                                       std::span<const std::string_view> extensions = {});
+        };
+
+        struct MetadataCacheStats {
+            u64 hits;
+            u64 misses;
+            u64 invalidations;
+            u64 generation;
+            size_t entries;
+        };
+
+        /// Remembers the stat() result of each path it's asked about, keyed by PathId, so repeated
+        /// Exists/IsFile/IsDirectory queries stop costing a syscall. Entries are dropped by feeding
+        /// FileWatcher changes to Invalidate(), or all at once with BumpGeneration().
+        ///
+        /// Opt-in: Path only consults the shared cache after SetEnabled(true), since without a
+        /// watcher or generation bumps it can go stale.
+        class MetadataCache {
+        public:
+            /// Returns the process-wide cache used by Path.
+            static MetadataCache& Get();
+
+            void SetEnabled(bool enabled);
+            [[nodiscard]] bool IsEnabled() const;
+
+            /// Cached metadata of `path`, stat()ing it on a miss. Missing paths are cached too.
+            FileMetadata Query(PathId path);
+
+            void Invalidate(PathId path);
+            /// Drops the changed paths and their parent directories. An Overflow change drops
+            /// everything.
+            void Invalidate(std::span<const FileChange> changes);
+            /// Invalidates every entry in O(1). They're refreshed lazily on their next query.
+            void BumpGeneration();
+
+            [[nodiscard]] MetadataCacheStats GetStats() const;
+            void ResetStats();
+
+        private:
+            struct Entry {
+                FileMetadata metadata;
+                u64 generation;
+            };
+
+            mutable std::shared_mutex _mutex;
+            unordered_map<PathId, Entry, PathId::Hash> _entries;
+            std::atomic<u64> _generation {0};
+            u64 _epoch = 0;  // Advanced by every Invalidate(), guarded by _mutex
+            std::atomic<bool> _enabled {false};
+
+            std::atomic<u64> _hits {0};
+            std::atomic<u64> _misses {0};
+            std::atomic<u64> _invalidations {0};
         };
     };  // namespace Filesystem
 }  // namespace x
+
+template<>
+struct std::hash<x::Filesystem::PathId> : x::Filesystem::PathId::Hash {};
@@ -0,0 +1,164 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#include "Hash.hpp"
+#include "Endian.hpp"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+namespace x {
+    static constexpr size_t kStripeSize      = 64;
+    static constexpr size_t kStripesPerBlock = 16;  // Accumulators get scrambled once per block
+    static constexpr size_t kBlockSize       = kStripeSize * kStripesPerBlock;
+
+    static constexpr u64 kPrime32_1 = 0x9E3779B1U;
+    static constexpr u64 kPrime32_2 = 0x85EBCA77U;
+    static constexpr u64 kPrime32_3 = 0xC2B2AE3DU;
+    static constexpr u64 kPrime64_1 = 0x9E3779B185EBCA87ULL;
+    static constexpr u64 kPrime64_2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr u64 kPrime64_3 = 0x165667B19E3779F9ULL;
+    static constexpr u64 kPrime64_4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr u64 kPrime64_5 = 0x27D4EB2F165667C5ULL;
+
+    // Stripe n of a block is keyed with secret words n to n + 7, so identical stripes at different
+    // positions don't cancel out in the accumulator sums
+    static constexpr size_t kSecretSize = kStripesPerBlock + 7;
+
+    struct Secrets {
+        u64 stripe[kSecretSize];
+        u64 scramble[8];
+    };
+
+    // Filled with SplitMix64 at compile time. Changing the start value changes every hash.
+    static constexpr Secrets kSecrets = [] {
+        Secrets secrets {};
+        u64 state       = 0x5851F42D4C957F2DULL;
+        const auto next = [&state] {
+            u64 value = state += 0x9E3779B97F4A7C15ULL;
+            value     = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            value     = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+            return value ^ (value >> 31);
+        };
+        for (auto& value : secrets.stripe) {
+            value = next();
+        }
+        for (auto& value : secrets.scramble) {
+            value = next();
+        }
+        return secrets;
+    }();
+
+    static u64 Mul128Fold64(const u64 a, const u64 b) {
+        const u128 product = CAST<u128>(a) * b;
+        return CAST<u64>(product) ^ CAST<u64>(product >> 64);
+    }
+
+    static u64 Avalanche(u64 hash) {
+        hash ^= hash >> 37;
+        hash *= 0x165667919E3779F9ULL;
+        return hash ^ (hash >> 32);
+    }
+
+#if !defined(__SSE2__)
+    static u64 Load64(const u8* data) {
+        u64 value;
+        std::memcpy(&value, data, sizeof(value));
+        return LittleEndian(value);
+    }
+#endif
+
+    // Runs `count` stripes through the accumulators, keying stripe n with secret[n..n + 8). Each
+    // lane adds the product of the two halves of (data ^ secret) to itself and the raw data to
+    // its neighbour, so no input bit is lost when a multiply by zero wipes the product.
+    static void Accumulate(u64* acc, const u8* data, const size_t count, const u64* secret) {
+#if defined(__SSE2__)
+        __m128i lanes[4];
+        for (int i = 0; i < 4; i++) {
+            lanes[i] = _mm_loadu_si128(RCAST<const __m128i*>(acc) + i);
+        }
+        for (size_t stripe = 0; stripe < count; stripe++) {
+            const auto* input = RCAST<const __m128i*>(data + stripe * kStripeSize);
+            for (int i = 0; i < 4; i++) {
+                const __m128i value   = _mm_loadu_si128(input + i);
+                const __m128i key = _mm_loadu_si128(RCAST<const __m128i*>(secret + stripe) + i);
+                const __m128i mixed   = _mm_xor_si128(value, key);
+                const __m128i high    = _mm_shuffle_epi32(mixed, _MM_SHUFFLE(0, 3, 0, 1));
+                const __m128i product = _mm_mul_epu32(mixed, high);
+                const __m128i swapped = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+                lanes[i] = _mm_add_epi64(product, _mm_add_epi64(lanes[i], swapped));
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            _mm_storeu_si128(RCAST<__m128i*>(acc) + i, lanes[i]);
+        }
+#else
+        for (size_t stripe = 0; stripe < count; stripe++) {
+            const u8* input = data + stripe * kStripeSize;
+            for (size_t i = 0; i < 8; i++) {
+                const u64 value = Load64(input + i * 8);
+                const u64 mixed = value ^ secret[stripe + i];
+                acc[i ^ 1] += value;
+                acc[i] += (mixed & 0xFFFFFFFF) * (mixed >> 32);
+            }
+        }
+#endif
+    }
+
+    static void Scramble(u64* acc) {
+        for (size_t i = 0; i < 8; i++) {
+            acc[i] ^= acc[i] >> 47;
+            acc[i] ^= kSecrets.scramble[i];
+            acc[i] *= kPrime32_1;
+        }
+    }
+
+    static u64 Merge(const u64* acc, const u64* secret, const u64 start) {
+        u64 result = start;
+        for (size_t i = 0; i < 4; i++) {
+            result += Mul128Fold64(acc[i * 2] ^ secret[i * 2], acc[i * 2 + 1] ^ secret[i * 2 + 1]);
+        }
+        return Avalanche(result);
+    }
+
+    u128 Hash128(std::span<const u8> data, const u64 seed) {
+        u64 secret[kSecretSize];
+        for (size_t i = 0; i < kSecretSize; i++) {
+            secret[i] = kSecrets.stripe[i] + (i % 2 == 0 ? seed : 0 - seed);
+        }
+        u64 acc[8] = {
+          kPrime32_3, kPrime64_1, kPrime64_2, kPrime64_3,
+          kPrime64_4, kPrime32_2, kPrime64_5, kPrime32_1,
+        };
+
+        const u8* input     = data.data();
+        const size_t size   = data.size();
+        const size_t blocks = size / kBlockSize;
+        for (size_t block = 0; block < blocks; block++) {
+            Accumulate(acc, input + block * kBlockSize, kStripesPerBlock, secret);
+            Scramble(acc);
+        }
+
+        const size_t tail    = size - blocks * kBlockSize;
+        const size_t stripes = tail / kStripeSize;
+        Accumulate(acc, input + blocks * kBlockSize, stripes, secret);
+        if (tail % kStripeSize != 0) {
+            if (size >= kStripeSize) {
+                // Overlap the last full stripe with bytes already hashed instead of padding. The
+                // tail has at most 15 full stripes, so the key of stripe 15 is free.
+                Accumulate(acc, input + size - kStripeSize, 1, secret + kStripesPerBlock - 1);
+            } else {
+                u8 padded[kStripeSize] = {};
+                std::memcpy(padded, input, size);
+                Accumulate(acc, padded, 1, secret + kStripesPerBlock - 1);
+            }
+        }
+
+        // The length is folded in here, which also tells zero padding apart from zero bytes
+        const u64 low  = Merge(acc, secret, size * kPrime64_1);
+        const u64 high = Merge(acc, kSecrets.scramble, ~(size * kPrime64_2) ^ seed);
+        return (CAST<u128>(high) << 64) | low;
+    }
+}  // namespace x
@@ -0,0 +1,43 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Types.hpp"
+
+#include <span>
+#include <string_view>
+
+namespace x {
+    static constexpr u64 kFnvOffsetBasis = 14695981039346656037ULL;
+    static constexpr u64 kFnvPrime       = 1099511628211ULL;
+
+    /// FNV-1a. Not fast on big buffers, but stable across platforms and builds, which is what
+    /// matters for hashes that get written to disk, and plenty fast for short keys like paths.
+    constexpr u64 Fnv1a64(std::string_view data, u64 hash = kFnvOffsetBasis) {
+        for (const char c : data) {
+            hash ^= CAST<u8>(c);
+            hash *= kFnvPrime;
+        }
+        return hash;
+    }
+
+    inline u64 Fnv1a64(std::span<const u8> data, u64 hash = kFnvOffsetBasis) {
+        for (const u8 byte : data) {
+            hash ^= byte;
+            hash *= kFnvPrime;
+        }
+        return hash;
+    }
+
+    /// 128-bit non-cryptographic hash for content addressing, built like XXH3: 64-byte stripes
+    /// feed eight 64-bit accumulators, four SSE2 registers on x86, which are folded down at the
+    /// end. Results are stable across platforms and builds, so they can name files on disk, but
+    /// don't match XXH3 itself.
+    u128 Hash128(std::span<const u8> data, u64 seed = 0);
+
+    inline u128 Hash128(std::string_view data, u64 seed = 0) {
+        return Hash128(std::span(RCAST<const u8*>(data.data()), data.size()), seed);
+    }
+}  // namespace x
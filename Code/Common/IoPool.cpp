@@ -0,0 +1,152 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#include "IoPool.hpp"
+
+#include <algorithm>
+
+namespace x::Filesystem {
+    static std::mutex gSharedPoolMutex;
+    static IoPoolConfig gSharedPoolConfig;
+
+    IoPool::IoPool(const IoPoolConfig& config)
+        : _capacity(std::max<size_t>(config.queueCapacity, 1)) {
+        u32 workerCount = config.workerCount;
+        if (workerCount == 0) {
+            // I/O threads spend most of their time blocked, but more than a handful of them
+            // just thrashes the disk queue
+            workerCount = std::clamp(std::thread::hardware_concurrency() / 2, 2U, 8U);
+        }
+
+        _workers.reserve(workerCount);
+        for (u32 i = 0; i < workerCount; i++) {
+            _workers.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    IoPool::~IoPool() {
+        {
+            std::lock_guard lock(_mutex);
+            _stopping = true;
+        }
+        _notEmpty.notify_all();
+        _notFull.notify_all();
+        for (auto& worker : _workers) {
+            if (worker.joinable()) { worker.join(); }
+        }
+    }
+
+    IoPool& IoPool::Get() {
+        static IoPool pool([] {
+            std::lock_guard lock(gSharedPoolMutex);
+            return gSharedPoolConfig;
+        }());
+        return pool;
+    }
+
+    void IoPool::Configure(const IoPoolConfig& config) {
+        std::lock_guard lock(gSharedPoolMutex);
+        gSharedPoolConfig = config;
+    }
+
+    bool IoPool::Enqueue(std::function<void()>&& run,
+                         const IoPriority priority,
+                         const CancellationToken& cancel,
+                         const bool block) {
+        {
+            std::unique_lock lock(_mutex);
+            auto hasRoom = [this]() { return _streaming.size() + _background.size() < _capacity; };
+            if (!block && !hasRoom()) { return false; }
+            _notFull.wait(lock, [this, &hasRoom]() { return _stopping || hasRoom(); });
+            if (_stopping) { return false; }
+
+            auto& queue = priority == IoPriority::Streaming ? _streaming : _background;
+            queue.push_back({std::move(run), cancel, Clock::now()});
+            _peakDepth = std::max(_peakDepth, _streaming.size() + _background.size());
+        }
+        _submitted.fetch_add(1, std::memory_order_relaxed);
+        _notEmpty.notify_one();
+        return true;
+    }
+
+    void IoPool::WorkerLoop() {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock lock(_mutex);
+                _notEmpty.wait(lock,
+                               [this]() {
+                                   return _stopping || !_streaming.empty() || !_background.empty();
+                               });
+                if (_streaming.empty() && _background.empty()) { return; }  // Stopping and drained
+
+                auto& queue = !_streaming.empty() ? _streaming : _background;
+                job         = std::move(queue.front());
+                queue.pop_front();
+            }
+            _notFull.notify_one();
+
+            if (job.cancel.IsCancelled()) {
+                _cancelled.fetch_add(1, std::memory_order_relaxed);
+                continue;  // Dropping the job breaks its promise
+            }
+
+            const auto started = Clock::now();
+            job.run();
+            const auto finished = Clock::now();
+
+            using std::chrono::duration_cast;
+            using std::chrono::microseconds;
+            const auto queueUs =
+              CAST<u64>(duration_cast<microseconds>(started - job.enqueued).count());
+            const auto runUs = CAST<u64>(duration_cast<microseconds>(finished - started).count());
+            _queueLatencyUs.fetch_add(queueUs, std::memory_order_relaxed);
+            _runLatencyUs.fetch_add(runUs, std::memory_order_relaxed);
+
+            u64 maxUs = _maxQueueLatencyUs.load(std::memory_order_relaxed);
+            while (queueUs > maxUs && !_maxQueueLatencyUs.compare_exchange_weak(maxUs, queueUs)) {}
+            _completed.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    IoPoolStats IoPool::GetStats() const {
+        IoPoolStats stats {};
+        {
+            std::lock_guard lock(_mutex);
+            stats.queueDepth     = _streaming.size() + _background.size();
+            stats.peakQueueDepth = _peakDepth;
+        }
+        stats.submitted         = _submitted.load(std::memory_order_relaxed);
+        stats.completed         = _completed.load(std::memory_order_relaxed);
+        stats.cancelled         = _cancelled.load(std::memory_order_relaxed);
+        stats.maxQueueLatencyUs = _maxQueueLatencyUs.load(std::memory_order_relaxed);
+        if (stats.completed > 0) {
+            const auto completed    = CAST<f64>(stats.completed);
+            stats.avgQueueLatencyUs = CAST<f64>(_queueLatencyUs.load()) / completed;
+            stats.avgRunLatencyUs   = CAST<f64>(_runLatencyUs.load()) / completed;
+        }
+        return stats;
+    }
+
+    void IoPool::ResetStats() {
+        {
+            std::lock_guard lock(_mutex);
+            _peakDepth = _streaming.size() + _background.size();
+        }
+        _submitted.store(0, std::memory_order_relaxed);
+        _completed.store(0, std::memory_order_relaxed);
+        _cancelled.store(0, std::memory_order_relaxed);
+        _queueLatencyUs.store(0, std::memory_order_relaxed);
+        _runLatencyUs.store(0, std::memory_order_relaxed);
+        _maxQueueLatencyUs.store(0, std::memory_order_relaxed);
+    }
+
+    u32 IoPool::GetWorkerCount() const {
+        return CAST<u32>(_workers.size());
+    }
+
+    void IoPoolExecutor::Schedule(std::coroutine_handle<> handle) {
+        if (!_pool.TrySubmit([handle] { handle.resume(); }, _priority)) { handle.resume(); }
+    }
+}  // namespace x::Filesystem
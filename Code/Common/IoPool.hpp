@@ -0,0 +1,204 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Types.hpp"
+#include "Task.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace x::Filesystem {
+    enum class IoPriority : u8 {
+        Streaming,   // Data something is waiting on this frame, always dequeued first
+        Background,  // Preloads, cache writes, anything that can wait
+    };
+
+    /// Shared cancellation flag. Copies refer to the same state, so the caller keeps one copy and
+    /// hands another to the pool. Jobs cancelled before a worker picks them up are dropped, which
+    /// makes their future throw std::future_error (broken_promise) on get().
+    class CancellationToken {
+    public:
+        CancellationToken() : _cancelled(make_shared<std::atomic<bool>>(false)) {}
+
+        void Cancel() const {
+            _cancelled->store(true, std::memory_order_release);
+        }
+
+        [[nodiscard]] bool IsCancelled() const {
+            return _cancelled->load(std::memory_order_acquire);
+        }
+
+    private:
+        shared_ptr<std::atomic<bool>> _cancelled;
+    };
+
+    struct IoPoolConfig {
+        u32 workerCount      = 0;  // 0 picks a count based on the hardware thread count
+        size_t queueCapacity = 1024;
+    };
+
+    struct IoPoolStats {
+        size_t queueDepth;
+        size_t peakQueueDepth;
+        u64 submitted;
+        u64 completed;
+        u64 cancelled;
+        f64 avgQueueLatencyUs;  // Time from submission until a worker picked the job up
+        f64 avgRunLatencyUs;    // Time spent executing the job
+        u64 maxQueueLatencyUs;
+    };
+
+    /// Fixed set of worker threads with a bounded job queue, shared by AsyncFileReader and
+    /// AsyncFileWriter. Submitting to a full queue blocks the caller until a slot frees up, so
+    /// don't submit from inside a job.
+    class IoPool {
+    public:
+        explicit IoPool(const IoPoolConfig& config = {});
+        ~IoPool();
+
+        IoPool(const IoPool&)            = delete;
+        IoPool& operator=(const IoPool&) = delete;
+
+        /// Returns the process-wide pool, creating it on first use.
+        static IoPool& Get();
+        /// Sets the config used to create the shared pool. Has no effect once Get() was called.
+        static void Configure(const IoPoolConfig& config);
+
+        template<typename Func>
+        auto Submit(Func&& func,
+                    IoPriority priority             = IoPriority::Background,
+                    const CancellationToken& cancel = {}) -> std::future<decltype(func())> {
+            using ReturnType = decltype(func());
+            auto task =
+              std::make_shared<std::packaged_task<ReturnType()>>(std::forward<Func>(func));
+            std::future<ReturnType> future = task->get_future();
+            Enqueue([task]() { (*task)(); }, priority, cancel, true);
+            return future;
+        }
+
+        /// Like Submit(), but returns Empty instead of blocking when the queue is full. Safe to
+        /// call from inside a job.
+        template<typename Func>
+        auto TrySubmit(Func&& func,
+                       IoPriority priority             = IoPriority::Background,
+                       const CancellationToken& cancel = {})
+          -> std::optional<std::future<decltype(func())>> {
+            using ReturnType = decltype(func());
+            auto task =
+              std::make_shared<std::packaged_task<ReturnType()>>(std::forward<Func>(func));
+            std::future<ReturnType> future = task->get_future();
+            if (!Enqueue([task]() { (*task)(); }, priority, cancel, false)) { return Empty; }
+            return future;
+        }
+
+        [[nodiscard]] IoPoolStats GetStats() const;
+        void ResetStats();
+        [[nodiscard]] u32 GetWorkerCount() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Job {
+            std::function<void()> run;
+            CancellationToken cancel;
+            Clock::time_point enqueued;
+        };
+
+        bool Enqueue(std::function<void()>&& run,
+                     IoPriority priority,
+                     const CancellationToken& cancel,
+                     bool block);
+        void WorkerLoop();
+
+        std::vector<std::thread> _workers;
+        std::deque<Job> _streaming;
+        std::deque<Job> _background;
+        size_t _capacity;
+        bool _stopping = false;
+
+        mutable std::mutex _mutex;
+        std::condition_variable _notEmpty;
+        std::condition_variable _notFull;
+
+        size_t _peakDepth = 0;
+        std::atomic<u64> _submitted {0};
+        std::atomic<u64> _completed {0};
+        std::atomic<u64> _cancelled {0};
+        std::atomic<u64> _queueLatencyUs {0};
+        std::atomic<u64> _runLatencyUs {0};
+        std::atomic<u64> _maxQueueLatencyUs {0};
+    };
+
+    /// Resumes coroutines as jobs on an IoPool, for chains that should run off the main thread.
+    /// When the queue is full the coroutine resumes right away on the scheduling thread instead
+    /// of blocking it, since that thread may well be a worker of the same pool.
+    class IoPoolExecutor final : public Executor {
+    public:
+        explicit IoPoolExecutor(IoPool& pool         = IoPool::Get(),
+                                IoPriority priority = IoPriority::Background)
+            : _pool(pool), _priority(priority) {}
+
+        void Schedule(std::coroutine_handle<> handle) override;
+
+    private:
+        IoPool& _pool;
+        IoPriority _priority;
+    };
+
+    /// Awaitable that runs `op` as a job on the shared IoPool and resumes the awaiting coroutine
+    /// on `executor` with its result, so no thread sits blocked on the I/O. If the queue is full
+    /// `op` runs inline on the awaiting thread instead. Exceptions from `op` are rethrown from the
+    /// co_await. Unlike Submit() there's no cancellation: a dropped job would leave the coroutine
+    /// suspended forever.
+    template<typename T>
+    class IoAwaitable {
+    public:
+        IoAwaitable(std::function<T()> op, Executor& executor, const IoPriority priority)
+            : _op(std::move(op)), _executor(&executor), _priority(priority) {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            // The coroutine may resume, and destroy this awaitable, before TrySubmit() returns,
+            // so nothing past this point may touch members unless the job wasn't queued
+            Executor* executor = _executor;
+            const auto queued  = IoPool::Get().TrySubmit(
+              [this, handle, executor] {
+                  // An exception has to reach the coroutine too, or it would never resume
+                  try {
+                      _result.emplace(_op());
+                  } catch (...) { _exception = std::current_exception(); }
+                  executor->Schedule(handle);
+              },
+              _priority);
+            if (queued) { return true; }
+
+            _result.emplace(_op());
+            return false;
+        }
+
+        T await_resume() {
+            if (_exception) { std::rethrow_exception(_exception); }
+            return std::move(*_result);
+        }
+
+    private:
+        std::function<T()> _op;
+        Executor* _executor;
+        IoPriority _priority;
+        std::optional<T> _result;
+        std::exception_ptr _exception;
+    };
+}  // namespace x::Filesystem
@@ -0,0 +1,500 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#include "IoUring.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <vector>
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+#endif
+
+namespace x::Filesystem {
+    // Longest read a single SQE is given. The kernel caps one read a bit below 2 GiB and the
+    // length field is 32 bits, so bigger requests are split. Keeps O_DIRECT alignment.
+    static constexpr size_t kMaxReadSize = 1ULL << 30;
+
+    // One SQE: a whole request, or a slice of one bigger than kMaxReadSize
+    struct IoUring::Slice {
+        Batch* batch;
+        ReadRequest* request;
+        u64 position;
+        u32 length;
+        i32 result = 0;
+        bool done  = false;  // Guarded by _inflightMutex, so a slice is only ever completed once
+    };
+
+    struct IoUring::Batch {
+        std::promise<bool> promise;
+        std::vector<Slice> slices;
+        std::vector<int> fds;
+        u32 remaining = 1;
+        bool ok       = true;
+
+        // Neighbours in IoUring::_live
+        Batch* prev = None;
+        Batch* next = None;
+
+        // Returns true when the caller retired the last read and must delete the batch
+        bool Retire() {
+            if (--remaining != 0) { return false; }
+#ifdef __linux__
+            for (const int fd : fds) {
+                close(fd);
+            }
+#endif
+            // Slices of a request finish in any order, stop counting at the first failed one
+            for (const Slice& slice : slices) {
+                ReadRequest& request = *slice.request;
+                if (request.error != 0 || slice.position != request.bytesRead) { continue; }
+                if (slice.result < 0) {
+                    request.error = -slice.result;
+                } else {
+                    request.bytesRead += CAST<size_t>(slice.result);
+                    if (CAST<u32>(slice.result) != slice.length) { request.error = EIO; }
+                }
+                if (request.error != 0) { ok = false; }
+            }
+            promise.set_value(ok);
+            return true;
+        }
+    };
+
+#ifdef __linux__
+    struct IoUring::Ring {
+        int fd = -1;
+        io_uring_params params {};
+
+        void* sqMap        = MAP_FAILED;
+        void* cqMap        = MAP_FAILED;
+        size_t sqMapSize   = 0;
+        size_t cqMapSize   = 0;
+        io_uring_sqe* sqes = None;
+
+        std::atomic<u32>* sqHead = None;
+        std::atomic<u32>* sqTail = None;
+        u32 sqMask               = 0;
+        u32* sqArray             = None;
+
+        std::atomic<u32>* cqHead = None;
+        std::atomic<u32>* cqTail = None;
+        u32 cqMask               = 0;
+        io_uring_cqe* cqes       = None;
+
+        // Tail we've filled up to but not yet published to the kernel
+        u32 localTail = 0;
+
+        ~Ring() {
+            if (sqes) { munmap(sqes, params.sq_entries * sizeof(io_uring_sqe)); }
+            if (cqMap != MAP_FAILED && cqMap != sqMap) { munmap(cqMap, cqMapSize); }
+            if (sqMap != MAP_FAILED) { munmap(sqMap, sqMapSize); }
+            if (fd >= 0) { close(fd); }
+        }
+
+        bool Init(const u32 entries) {
+            fd = CAST<int>(syscall(__NR_io_uring_setup, entries, &params));
+            if (fd < 0) { return false; }
+
+            sqMapSize = params.sq_off.array + params.sq_entries * sizeof(u32);
+            cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (singleMap) { sqMapSize = cqMapSize = std::max(sqMapSize, cqMapSize); }
+
+            sqMap = mmap(None,
+                         sqMapSize,
+                         PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE,
+                         fd,
+                         IORING_OFF_SQ_RING);
+            if (sqMap == MAP_FAILED) { return false; }
+            cqMap = singleMap ? sqMap
+                              : mmap(None,
+                                     cqMapSize,
+                                     PROT_READ | PROT_WRITE,
+                                     MAP_SHARED | MAP_POPULATE,
+                                     fd,
+                                     IORING_OFF_CQ_RING);
+            if (cqMap == MAP_FAILED) { return false; }
+
+            void* sqeMap = mmap(None,
+                                params.sq_entries * sizeof(io_uring_sqe),
+                                PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE,
+                                fd,
+                                IORING_OFF_SQES);
+            if (sqeMap == MAP_FAILED) { return false; }
+            sqes = CAST<io_uring_sqe*>(sqeMap);
+
+            auto* sq  = CAST<u8*>(sqMap);
+            sqHead    = RCAST<std::atomic<u32>*>(sq + params.sq_off.head);
+            sqTail    = RCAST<std::atomic<u32>*>(sq + params.sq_off.tail);
+            sqMask    = *RCAST<u32*>(sq + params.sq_off.ring_mask);
+            sqArray   = RCAST<u32*>(sq + params.sq_off.array);
+            localTail = sqTail->load(std::memory_order_relaxed);
+
+            auto* cq = CAST<u8*>(cqMap);
+            cqHead   = RCAST<std::atomic<u32>*>(cq + params.cq_off.head);
+            cqTail   = RCAST<std::atomic<u32>*>(cq + params.cq_off.tail);
+            cqMask   = *RCAST<u32*>(cq + params.cq_off.ring_mask);
+            cqes     = RCAST<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+            return true;
+        }
+
+        // Returns a zeroed SQE, or null when the submission ring is full
+        io_uring_sqe* NextSqe() {
+            const u32 head = sqHead->load(std::memory_order_acquire);
+            if (localTail - head >= params.sq_entries) { return None; }
+            const u32 index = localTail & sqMask;
+            sqArray[index]  = index;
+            localTail++;
+            io_uring_sqe* sqe = &sqes[index];
+            std::memset(sqe, 0, sizeof(io_uring_sqe));
+            return sqe;
+        }
+
+        // Publishes filled SQEs to the kernel, returns how many are waiting to be submitted
+        u32 Publish() {
+            const u32 tail = sqTail->load(std::memory_order_relaxed);
+            sqTail->store(localTail, std::memory_order_release);
+            return localTail - tail;
+        }
+
+        int Enter(const u32 toSubmit, const u32 minComplete, const u32 flags) const {
+            return CAST<int>(
+              syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, None, 0));
+        }
+    };
+
+    bool IoUring::IsSupported() {
+        static const bool supported = [] {
+            io_uring_params params {};
+            const int fd = CAST<int>(syscall(__NR_io_uring_setup, 1, &params));
+            if (fd < 0) { return false; }
+            close(fd);
+            // IORING_OP_READ needs 5.6, which is also the release that added this feature flag
+            return (params.features & IORING_FEAT_RW_CUR_POS) != 0;
+        }();
+        return supported;
+    }
+
+    IoUring::IoUring(const u32 entries) : _ring(make_unique<Ring>()) {
+        if (!IsSupported() || !_ring->Init(entries)) {
+            _ring.reset();
+            return;
+        }
+        // Keep completions from overflowing the CQ ring
+        _maxInflight = _ring->params.cq_entries;
+        _reaper      = std::thread([this]() { ReapLoop(); });
+    }
+
+    IoUring::~IoUring() {
+        if (!_ring) { return; }
+        {
+            std::lock_guard lock(_inflightMutex);
+            _stopping = true;
+        }
+        _inflightCv.notify_all();
+        if (_reaper.joinable()) { _reaper.join(); }
+    }
+
+    bool IoUring::IsValid() const {
+        return _ring != None && _failure.load(std::memory_order_acquire) == 0;
+    }
+
+    bool IoUring::RegisterBuffers(std::span<const std::span<u8>> buffers) {
+        if (!_ring) { return false; }
+        UnregisterBuffers();
+
+        std::vector<iovec> iovecs;
+        iovecs.reserve(buffers.size());
+        for (const auto& buffer : buffers) {
+            iovecs.push_back({buffer.data(), buffer.size()});
+        }
+        const auto result = syscall(__NR_io_uring_register,
+                                    _ring->fd,
+                                    IORING_REGISTER_BUFFERS,
+                                    iovecs.data(),
+                                    CAST<u32>(iovecs.size()));
+        _buffersRegistered = result == 0;
+        return _buffersRegistered;
+    }
+
+    void IoUring::UnregisterBuffers() {
+        if (!_ring || !_buffersRegistered) { return; }
+        syscall(__NR_io_uring_register, _ring->fd, IORING_UNREGISTER_BUFFERS, None, 0);
+        _buffersRegistered = false;
+    }
+
+    void IoUring::CompleteLocked(Slice& slice, const i32 result) {
+        if (slice.done) { return; }
+        slice.done   = true;
+        slice.result = result;
+        ReleaseLocked(slice.batch);
+    }
+
+    void IoUring::ReleaseLocked(Batch* batch) {
+        if (!batch->Retire()) { return; }
+        (batch->prev ? batch->prev->next : _live) = batch->next;
+        if (batch->next) { batch->next->prev = batch->prev; }
+        delete batch;
+    }
+
+    void IoUring::FailLocked(const i32 error) {
+        _failure.store(error, std::memory_order_release);
+
+        // Collect first, completing the last open slice of a batch may delete it
+        std::vector<Slice*> open;
+        for (Batch* batch = _live; batch; batch = batch->next) {
+            for (Slice& slice : batch->slices) {
+                if (!slice.done) { open.push_back(&slice); }
+            }
+        }
+        for (Slice* slice : open) {
+            CompleteLocked(*slice, -error);
+        }
+    }
+
+    bool IoUring::Flush() {
+        u32 count = _ring->Publish();
+        // Held across the submit, so FailLocked() either sees these reads in flight or Flush()
+        // sees the failure and never hands them to a ring nobody reaps anymore
+        std::unique_lock lock(_inflightMutex);
+        while (count > 0) {
+            i32 error = _failure.load(std::memory_order_relaxed);
+            if (error == 0) {
+                const int submitted = _ring->Enter(count, 0, 0);
+                if (submitted >= 0) {
+                    count -= CAST<u32>(submitted);
+                    _submitted += submitted;
+                    continue;
+                }
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                    // EBUSY waits for the reaper to drain the CQ ring, which needs the lock
+                    lock.unlock();
+                    std::this_thread::yield();
+                    lock.lock();
+                    continue;
+                }
+                error = errno;
+            }
+
+            // The kernel never took these SQEs, pull them back out of the ring and fail their
+            // reads so the batches still complete
+            const u32 head = _ring->sqHead->load(std::memory_order_acquire);
+            for (u32 i = head; i != _ring->localTail; i++) {
+                const io_uring_sqe& sqe = _ring->sqes[_ring->sqArray[i & _ring->sqMask]];
+                CompleteLocked(*RCAST<Slice*>(sqe.user_data), -error);
+            }
+            _inflight -= _ring->localTail - head;
+            _ring->sqTail->store(head, std::memory_order_release);
+            _ring->localTail = head;
+            lock.unlock();
+            _inflightCv.notify_all();
+            return false;
+        }
+        lock.unlock();
+        _inflightCv.notify_all();
+        return true;
+    }
+
+    std::future<bool> IoUring::SubmitReads(std::span<ReadRequest> requests, const bool directIo) {
+        auto owned  = make_unique<Batch>();
+        auto future = owned->promise.get_future();
+        if (const i32 error = _ring ? _failure.load(std::memory_order_acquire) : ENOSYS) {
+            for (auto& request : requests) {
+                request.error = error;
+            }
+            owned->promise.set_value(false);
+            return future;
+        }
+
+        // `remaining` starts at 1, which keeps the batch alive until every SQE has been queued
+        // even if the reaper retires the reads that were already submitted. SQEs point into
+        // `slices`, so it must never reallocate.
+        size_t sliceCount = 0;
+        for (const auto& request : requests) {
+            const size_t size = request.buffer.size();
+            sliceCount += std::max<size_t>((size + kMaxReadSize - 1) / kMaxReadSize, 1);
+        }
+        owned->slices.reserve(sliceCount);
+        owned->fds.reserve(requests.size());
+
+        Batch* batch = owned.release();
+        {
+            std::lock_guard lock(_inflightMutex);
+            batch->next = _live;
+            if (_live) { _live->prev = batch; }
+            _live = batch;
+        }
+
+        // Requests commonly hit the same archive many times, so only open each path once
+        unordered_map<str, int> openFiles;
+        const int openFlags = O_RDONLY | O_CLOEXEC | (directIo ? O_DIRECT : 0);
+
+        std::lock_guard lock(_submitMutex);
+        i32 failure = 0;  // Set once the ring broke, the remaining requests fail with it
+        for (auto& request : requests) {
+            request.bytesRead = 0;
+            request.error     = 0;
+            if (failure != 0) {
+                request.error = failure;
+                batch->ok     = false;
+                continue;
+            }
+
+            auto it = openFiles.find(request.path);
+            if (it == openFiles.end()) {
+                int fd = open(request.path.c_str(), openFlags);
+                // Filesystems like tmpfs reject O_DIRECT, fall back to buffered reads for those
+                if (fd < 0 && directIo && errno == EINVAL) {
+                    fd = open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+                }
+                if (fd >= 0) { batch->fds.push_back(fd); }
+                it = openFiles.emplace(request.path, fd >= 0 ? fd : -errno).first;
+            }
+
+            if (it->second < 0) {
+                request.error = -it->second;
+                batch->ok     = false;
+                continue;
+            }
+
+            const bool fixed = request.bufferIndex >= 0 && _buffersRegistered;
+            size_t position  = 0;
+            do {
+                const auto length =
+                  CAST<u32>(std::min(request.buffer.size() - position, kMaxReadSize));
+                {
+                    // Don't queue more reads than the CQ ring can hold completions for
+                    std::unique_lock inflightLock(_inflightMutex);
+                    const bool broken = _failure.load(std::memory_order_relaxed) != 0;
+                    if (_inflight >= _maxInflight && !broken) {
+                        inflightLock.unlock();
+                        Flush();
+                        inflightLock.lock();
+                        _inflightCv.wait(inflightLock, [this]() {
+                            return _inflight < _maxInflight ||
+                                   _failure.load(std::memory_order_relaxed) != 0;
+                        });
+                    }
+                    failure = _failure.load(std::memory_order_relaxed);
+                    if (failure != 0) {
+                        request.error = failure;
+                        batch->ok     = false;
+                        break;
+                    }
+                    _inflight++;
+                    // FailLocked() walks the slices under this lock
+                    batch->remaining++;
+                    batch->slices.push_back({batch, &request, position, length});
+                }
+
+                // A failed Flush() takes its SQEs back, so this frees up space either way
+                io_uring_sqe* sqe = _ring->NextSqe();
+                while (!sqe) {
+                    Flush();
+                    sqe = _ring->NextSqe();
+                }
+
+                sqe->opcode    = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+                sqe->fd        = it->second;
+                sqe->off       = request.offset + position;
+                sqe->addr      = RCAST<u64>(request.buffer.data() + position);
+                sqe->len       = length;
+                sqe->buf_index = fixed ? CAST<u16>(request.bufferIndex) : 0;
+                sqe->user_data = RCAST<u64>(&batch->slices.back());
+                position += length;
+            } while (position < request.buffer.size());
+        }
+        Flush();
+
+        // Drop the guard reference, the reaper owns the batch if anything is still in flight
+        std::lock_guard inflightLock(_inflightMutex);
+        ReleaseLocked(batch);
+        return future;
+    }
+
+    void IoUring::ReapLoop() {
+        for (;;) {
+            {
+                // Only block in the kernel while it owes us completions. `_submitted` can dip
+                // below zero when a read completes before Flush() counted it.
+                std::unique_lock lock(_inflightMutex);
+                _inflightCv.wait(lock, [this]() { return _stopping || _submitted > 0; });
+                if (_submitted <= 0) { return; }
+            }
+
+            const int result = _ring->Enter(0, 1, IORING_ENTER_GETEVENTS);
+            const bool fatal = result < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY;
+            const i32 error  = fatal ? errno : 0;
+
+            std::unique_lock lock(_inflightMutex);
+            u32 head         = _ring->cqHead->load(std::memory_order_relaxed);
+            const u32 tail   = _ring->cqTail->load(std::memory_order_acquire);
+            const u32 reaped = tail - head;
+            for (; head != tail; head++) {
+                const io_uring_cqe& cqe = _ring->cqes[head & _ring->cqMask];
+                CompleteLocked(*RCAST<Slice*>(cqe.user_data), cqe.res);
+            }
+            _ring->cqHead->store(head, std::memory_order_release);
+            _inflight -= reaped;
+            _submitted -= reaped;
+
+            if (fatal) {
+                // Nothing will wait for completions anymore. Fail whatever is still in flight,
+                // IsValid() turns false and callers fall back to blocking reads.
+                FailLocked(error);
+                lock.unlock();
+                _inflightCv.notify_all();
+                return;
+            }
+            lock.unlock();
+            if (reaped > 0) { _inflightCv.notify_all(); }
+        }
+    }
+#else
+    struct IoUring::Ring {};
+
+    bool IoUring::IsSupported() {
+        return false;
+    }
+
+    IoUring::IoUring(u32) {}
+
+    IoUring::~IoUring() = default;
+
+    bool IoUring::IsValid() const {
+        return false;
+    }
+
+    bool IoUring::RegisterBuffers(std::span<const std::span<u8>>) {
+        return false;
+    }
+
+    void IoUring::UnregisterBuffers() {}
+
+    bool IoUring::Flush() {
+        return false;
+    }
+
+    std::future<bool> IoUring::SubmitReads(std::span<ReadRequest> requests, bool) {
+        for (auto& request : requests) {
+            request.error = ENOSYS;
+        }
+        std::promise<bool> promise;
+        promise.set_value(false);
+        return promise.get_future();
+    }
+
+    void IoUring::ReapLoop() {}
+#endif
+}  // namespace x::Filesystem
@@ -0,0 +1,84 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Types.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <span>
+#include <thread>
+
+namespace x::Filesystem {
+    /// A positional read into caller-owned memory. The read size is `buffer.size()`, and the
+    /// buffer must stay alive until the batch it was submitted with completes. Reads bigger
+    /// than 1 GiB are split into several SQEs.
+    struct ReadRequest {
+        str path;
+        u64 offset = 0;
+        std::span<u8> buffer;
+        i32 bufferIndex = -1;  // Registered buffer that contains `buffer`, or -1
+
+        // Filled in on completion
+        size_t bytesRead = 0;
+        i32 error        = 0;  // errno value, 0 on success
+    };
+
+    /// Thin io_uring wrapper (raw syscalls, no liburing) that submits a whole batch of reads with a
+    /// single io_uring_enter and reaps completions on one background thread. Only available on
+    /// Linux 5.6+ and when io_uring isn't blocked by seccomp, check IsSupported() first.
+    class IoUring {
+    public:
+        explicit IoUring(u32 entries = 256);
+        ~IoUring();
+
+        IoUring(const IoUring&)            = delete;
+        IoUring& operator=(const IoUring&) = delete;
+
+        [[nodiscard]] static bool IsSupported();
+        /// False if the ring couldn't be set up, or stopped working: batches in flight then fail
+        /// with the error and later SubmitReads() calls fail right away.
+        [[nodiscard]] bool IsValid() const;
+
+        /// Registers fixed buffers for IORING_OP_READ_FIXED. Must be called while no reads are in
+        /// flight, and replaces any previously registered set.
+        bool RegisterBuffers(std::span<const std::span<u8>> buffers);
+        void UnregisterBuffers();
+
+        /// Submits every request in one go. The future is set to true once all reads completed
+        /// in full; check each request's `error`/`bytesRead` when it's false. `directIo` opens
+        /// files with O_DIRECT, which requires block aligned offsets, sizes, and buffers.
+        std::future<bool> SubmitReads(std::span<ReadRequest> requests, bool directIo = false);
+
+    private:
+        struct Ring;
+        struct Slice;
+        struct Batch;
+
+        void ReapLoop();
+        // These need _inflightMutex held
+        void CompleteLocked(Slice& slice, i32 result);
+        void ReleaseLocked(Batch* batch);
+        void FailLocked(i32 error);
+        /// Publishes and submits the queued SQEs. If the kernel refuses them, their reads are
+        /// failed with the errno and false is returned.
+        bool Flush();
+
+        unique_ptr<Ring> _ring;
+        std::thread _reaper;
+        std::mutex _submitMutex;
+        std::mutex _inflightMutex;
+        std::condition_variable _inflightCv;
+        u32 _inflight           = 0;
+        u32 _maxInflight        = 0;
+        i64 _submitted          = 0;  // Reads the kernel took that the reaper hasn't retired
+        bool _stopping          = false;
+        Batch* _live            = None;  // Batches with reads outstanding
+        std::atomic<i32> _failure {0};   // errno that broke the ring, 0 while it works
+        bool _buffersRegistered = false;
+    };
+}  // namespace x::Filesystem
@@ -0,0 +1,270 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#include "JobSystem.hpp"
+
+namespace x {
+    struct Job {
+        JobSystem::JobFunc func;
+        JobCounter* counter;
+    };
+
+    // Idle rounds a worker yields through before it goes to sleep
+    static constexpr u32 kSpinCount = 64;
+
+    static std::mutex gSharedSystemMutex;
+    static JobSystemConfig gSharedSystemConfig;
+
+    // Which system the current thread belongs to, and its deque index there
+    static thread_local const JobSystem* tSystem = None;
+    static thread_local u32 tIndex               = 0;
+
+    // Picks where thieves start looking, so they don't all pile onto the same victim
+    static u32 NextRandom() {
+        thread_local u32 state =
+          CAST<u32>(std::hash<std::thread::id> {}(std::this_thread::get_id())) | 1;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    JobSystem::JobSystem(const JobSystemConfig& config)
+        : _mainThread(std::this_thread::get_id()), _injected(config.mainQueueCapacity),
+          _mainJobs(config.mainQueueCapacity) {
+        const u32 threadCount =
+          config.threadCount > 0 ? config.threadCount : std::thread::hardware_concurrency();
+        const u32 workerCount = std::max(threadCount, 1U) - 1;
+
+        for (u32 i = 0; i <= workerCount; i++) {
+            _deques.push_back(make_unique<WorkStealingDeque<Job*>>());
+        }
+        tSystem = this;
+        tIndex  = 0;
+
+        _workers.reserve(workerCount);
+        for (u32 i = 1; i <= workerCount; i++) {
+            _workers.emplace_back([this, i] { WorkerLoop(i); });
+        }
+    }
+
+    JobSystem::~JobSystem() {
+        _stopping.store(true);
+        {
+            std::lock_guard lock(_sleepMutex);
+        }
+        _wake.notify_all();
+        for (auto& worker : _workers) {
+            if (worker.joinable()) { worker.join(); }
+        }
+
+        // Run whatever is still queued, so no counter is left waiting forever
+        while (Job* job = FindJob(CurrentIndex())) {
+            Execute(job);
+        }
+        Job* job;
+        while (_mainJobs.TryPop(job)) {
+            Execute(job);
+        }
+        if (tSystem == this) { tSystem = None; }
+    }
+
+    JobSystem& JobSystem::Get() {
+        static JobSystem system([] {
+            std::lock_guard lock(gSharedSystemMutex);
+            return gSharedSystemConfig;
+        }());
+        return system;
+    }
+
+    void JobSystem::Configure(const JobSystemConfig& config) {
+        std::lock_guard lock(gSharedSystemMutex);
+        gSharedSystemConfig = config;
+    }
+
+    void JobSystem::Run(JobFunc func, JobCounter* counter) {
+        if (counter) { counter->_count.fetch_add(1); }
+        Submit(new Job {std::move(func), counter});
+    }
+
+    void JobSystem::RunAfter(JobCounter& dependency, JobFunc func, JobCounter* counter) {
+        if (counter) { counter->_count.fetch_add(1); }
+        auto* job = new Job {std::move(func), counter};
+
+        vector<Job*> ready;
+        {
+            std::lock_guard lock(dependency._mutex);
+            dependency._continuations.push_back(job);
+            // Pairs with Finish(): either it sees the flag, or this sees the count at zero
+            dependency._hasContinuations.store(true);
+            if (dependency._count.load() == 0) {
+                ready.swap(dependency._continuations);
+                dependency._hasContinuations.store(false);
+            }
+        }
+        if (ready.empty()) { return; }
+
+        // A job that brought the count to zero may still be inside Finish(). Once a continuation
+        // runs, whoever waits on it may destroy `dependency`, so let those jobs leave first.
+        while (dependency._finishing.load() != 0) {
+            std::this_thread::yield();
+        }
+        for (Job* continuation : ready) {
+            Submit(continuation);
+        }
+    }
+
+    void JobSystem::RunOnMainThread(JobFunc func, JobCounter* counter) {
+        if (counter) { counter->_count.fetch_add(1); }
+        auto* job = new Job {std::move(func), counter};
+        while (!_mainJobs.TryPush(job)) {
+            if (IsMainThread()) {
+                RunMainThreadJobs();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    size_t JobSystem::RunMainThreadJobs() {
+        if (!IsMainThread()) { return 0; }
+        // Bounded, so a job that queues another one doesn't keep the frame from ending
+        const size_t limit = _mainJobs.SizeApprox();
+        size_t ran         = 0;
+        Job* job;
+        while (ran < limit && _mainJobs.TryPop(job)) {
+            Execute(job);
+            ran++;
+        }
+        return ran;
+    }
+
+    void JobSystem::Wait(JobCounter& counter) {
+        const bool isMain = IsMainThread();
+        const u32 index   = CurrentIndex();
+        while (!counter.IsDone()) {
+            Job* job;
+            if (isMain && _mainJobs.TryPop(job)) {
+                Execute(job);
+            } else if ((job = FindJob(index))) {
+                Execute(job);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    u32 JobSystem::GetThreadCount() const {
+        return CAST<u32>(_deques.size());
+    }
+
+    bool JobSystem::IsMainThread() const {
+        return std::this_thread::get_id() == _mainThread;
+    }
+
+    void JobSystem::Submit(Job* job) {
+        _pending.fetch_add(1);
+        if (const u32 index = CurrentIndex(); index != kNotAWorker) {
+            _deques[index]->Push(job);
+        } else {
+            while (!_injected.TryPush(job)) {
+                std::this_thread::yield();
+            }
+        }
+
+        // Pairs with the sleep in WorkerLoop(): either the worker sees _pending, or this sees it
+        // sleeping and the empty critical section makes sure it's actually waiting
+        if (_sleeping.load() > 0) {
+            {
+                std::lock_guard lock(_sleepMutex);
+            }
+            _wake.notify_one();
+        }
+    }
+
+    void JobSystem::Execute(Job* job) {
+        job->func();
+        JobCounter* counter = job->counter;
+        delete job;
+        if (counter) { Finish(*counter); }
+    }
+
+    void JobSystem::Finish(JobCounter& counter) {
+        counter._finishing.fetch_add(1);
+        vector<Job*> ready;
+        if (counter._count.fetch_sub(1) == 1 && counter._hasContinuations.load()) {
+            std::lock_guard lock(counter._mutex);
+            ready.swap(counter._continuations);
+            counter._hasContinuations.store(false);
+        }
+        // Last touch. A waiter, or a continuation's waiter, may destroy the counter from here on,
+        // so the continuations only go out afterwards.
+        counter._finishing.fetch_sub(1);
+        for (Job* continuation : ready) {
+            Submit(continuation);
+        }
+    }
+
+    Job* JobSystem::FindJob(const u32 index) {
+        if (index != kNotAWorker) {
+            if (const auto job = _deques[index]->Pop()) {
+                _pending.fetch_sub(1);
+                return *job;
+            }
+        }
+
+        Job* job;
+        if (_injected.TryPop(job)) {
+            _pending.fetch_sub(1);
+            return job;
+        }
+
+        const size_t count = _deques.size();
+        const size_t start = NextRandom() % count;
+        for (size_t i = 0; i < count; i++) {
+            const size_t victim = (start + i) % count;
+            if (victim == index) { continue; }
+            if (const auto stolen = _deques[victim]->Steal()) {
+                _pending.fetch_sub(1);
+                return *stolen;
+            }
+        }
+        return None;
+    }
+
+    bool JobSystem::ShouldSplit() const {
+        if (const u32 index = CurrentIndex(); index != kNotAWorker) {
+            return _deques[index]->SizeApprox() < 2;
+        }
+        return _pending.load(std::memory_order_relaxed) < GetThreadCount();
+    }
+
+    u32 JobSystem::CurrentIndex() const {
+        return tSystem == this ? tIndex : kNotAWorker;
+    }
+
+    void JobSystem::WorkerLoop(const u32 index) {
+        tSystem = this;
+        tIndex  = index;
+
+        u32 idle = 0;
+        while (!_stopping.load(std::memory_order_relaxed)) {
+            if (Job* job = FindJob(index)) {
+                Execute(job);
+                idle = 0;
+                continue;
+            }
+            if (++idle < kSpinCount) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            idle = 0;
+            std::unique_lock lock(_sleepMutex);
+            _sleeping.fetch_add(1);
+            _wake.wait(lock, [this] { return _pending.load() > 0 || _stopping.load(); });
+            _sleeping.fetch_sub(1);
+        }
+    }
+}  // namespace x
@@ -0,0 +1,140 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Types.hpp"
+#include "Queue.hpp"
+#include "WorkStealingDeque.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace x {
+    struct Job;
+
+    /// Counts the unfinished jobs submitted against it. Wait on it, or chain jobs behind it with
+    /// RunAfter() to build a task graph. A counter can be destroyed or reused once Wait() on it
+    /// returned, or once a job chained behind it with RunAfter() has started; no job touches it
+    /// after that. Until then it must stay alive.
+    class JobCounter {
+    public:
+        JobCounter() = default;
+
+        JobCounter(const JobCounter&)            = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        [[nodiscard]] bool IsDone() const {
+            return _count.load() == 0 && _finishing.load() == 0;
+        }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<i64> _count {0};
+        // Jobs inside Finish(), so IsDone() only turns true once nobody touches the counter
+        std::atomic<i64> _finishing {0};
+
+        std::mutex _mutex;
+        vector<Job*> _continuations;  // Submitted once _count drops to zero
+        std::atomic<bool> _hasContinuations {false};
+    };
+
+    struct JobSystemConfig {
+        u32 threadCount          = 0;  // Including the main thread, 0 uses one per hardware thread
+        size_t mainQueueCapacity = 4096;  // Also bounds jobs queued from non-worker threads
+    };
+
+    /// Work-stealing job system for CPU work: culling, command recording, asset cooking. Each
+    /// worker owns a Chase-Lev deque, pushes the jobs it spawns there and steals from the others
+    /// when it runs dry; jobs submitted from outside go through a shared queue. Threads that wait
+    /// on a counter run jobs until it's done instead of blocking, so nested waits are fine.
+    ///
+    /// The thread that creates the system is the main thread, and jobs submitted with
+    /// RunOnMainThread() only ever run there, from RunMainThreadJobs() or inside Wait(), for
+    /// APIs like GLFW that must be called from it. Blocking I/O belongs on the IoPool instead.
+    class JobSystem {
+    public:
+        using JobFunc = std::function<void()>;
+
+        explicit JobSystem(const JobSystemConfig& config = {});
+        ~JobSystem();
+
+        JobSystem(const JobSystem&)            = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        /// Returns the process-wide job system, creating it on first use. Call it from the main
+        /// thread first.
+        static JobSystem& Get();
+        /// Sets the config used to create the shared system. Has no effect once Get() was called.
+        static void Configure(const JobSystemConfig& config);
+
+        void Run(JobFunc func, JobCounter* counter = None);
+        /// Runs `func` once `dependency` reaches zero, right away if it already has.
+        void RunAfter(JobCounter& dependency, JobFunc func, JobCounter* counter = None);
+        void RunOnMainThread(JobFunc func, JobCounter* counter = None);
+
+        /// Runs the main-thread jobs queued so far and returns how many ran. Call it once per
+        /// frame from the main thread.
+        size_t RunMainThreadJobs();
+
+        /// Runs jobs until `counter` reaches zero.
+        void Wait(JobCounter& counter);
+
+        /// Calls `func(i)` for every i in [0, count) across the workers and returns once all calls
+        /// are done. Ranges are split in half lazily, only while the splitting thread's own
+        /// deque is nearly empty, so the grain adapts to how busy the other workers are. No range
+        /// gets smaller than `minGrain`.
+        template<typename Func>
+        void ParallelFor(const u64 count, Func&& func, const u64 minGrain = 1) {
+            if (count == 0) { return; }
+            const u64 grain = std::max<u64>({minGrain, count / (GetThreadCount() * 16ULL), 1});
+
+            JobCounter counter;
+            std::function<void(u64, u64)> run = [&](u64 begin, u64 end) {
+                while (end - begin > grain && ShouldSplit()) {
+                    const u64 middle = begin + (end - begin) / 2;
+                    Run([&run, middle, end] { run(middle, end); }, &counter);
+                    end = middle;
+                }
+                for (u64 i = begin; i < end; i++) {
+                    func(i);
+                }
+            };
+            run(0, count);
+            Wait(counter);
+        }
+
+        /// Worker threads plus the main thread.
+        [[nodiscard]] u32 GetThreadCount() const;
+        [[nodiscard]] bool IsMainThread() const;
+
+    private:
+        static constexpr u32 kNotAWorker = ~0U;
+
+        void Submit(Job* job);
+        void Execute(Job* job);
+        void Finish(JobCounter& counter);
+        Job* FindJob(u32 index);
+        // Whether the calling thread should hand half its range to the other workers
+        bool ShouldSplit() const;
+        u32 CurrentIndex() const;
+        void WorkerLoop(u32 index);
+
+        std::thread::id _mainThread;
+        vector<unique_ptr<WorkStealingDeque<Job*>>> _deques;  // Index 0 is the main thread's
+        MpmcQueue<Job*> _injected;                            // From threads without a deque
+        MpmcQueue<Job*> _mainJobs;
+        vector<std::thread> _workers;
+
+        alignas(kCacheLineSize) std::atomic<i64> _pending {0};  // Jobs in deques or _injected
+        std::atomic<u32> _sleeping {0};
+        std::atomic<bool> _stopping {false};
+        std::mutex _sleepMutex;
+        std::condition_variable _wake;
+    };
+}  // namespace x
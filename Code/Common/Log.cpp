@@ -0,0 +1,221 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#include "Log.hpp"
+
+#include <bit>
+
+namespace x {
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr auto kDrainInterval      = std::chrono::milliseconds(5);
+    static constexpr size_t kMaxMessageLength = 2048;
+    static constexpr size_t kMinBufferSize    = 4096;
+
+    static std::mutex gSharedLoggerMutex;
+    static LoggerConfig gSharedLoggerConfig;
+
+    static cstr LevelName(const LogLevel level) {
+        switch (level) {
+            case LogLevel::Trace:
+                return "TRACE";
+            case LogLevel::Debug:
+                return "DEBUG";
+            case LogLevel::Info:
+                return "INFO";
+            case LogLevel::Warn:
+                return "WARN";
+            case LogLevel::Error:
+                return "ERROR";
+            case LogLevel::Fatal:
+                return "FATAL";
+        }
+        return "";
+    }
+
+    // Appends one formatted line to `text`, warnings and errors with where they were logged and
+    // fatal ones in the layout Panic has always used
+    static void AppendLine(str& text,
+                           const f64 seconds,
+                           const u32 thread,
+                           const LogLevel level,
+                           const LogSite* site,
+                           const cstr message) {
+        char line[kMaxMessageLength + 512];
+        i32 length;
+        if (level == LogLevel::Fatal && site) {
+            length = std::snprintf(line,
+                                   sizeof(line),
+                                   "%s:%d :: PANIC\n -- In function: `%s`\n -- Error: %s\n",
+                                   site->file,
+                                   site->line,
+                                   site->function,
+                                   message);
+        } else if (level >= LogLevel::Warn && site) {
+            length = std::snprintf(line,
+                                   sizeof(line),
+                                   "[%11.6f] [T%u] %-5s %s  (%s:%d)\n",
+                                   seconds,
+                                   thread,
+                                   LevelName(level),
+                                   message,
+                                   site->file,
+                                   site->line);
+        } else {
+            length = std::snprintf(line,
+                                   sizeof(line),
+                                   "[%11.6f] [T%u] %-5s %s\n",
+                                   seconds,
+                                   thread,
+                                   LevelName(level),
+                                   message);
+        }
+        if (length > 0) { text.append(line, std::min(CAST<size_t>(length), sizeof(line) - 1)); }
+    }
+
+    LogBuffer::LogBuffer(const size_t capacity, const u32 thread)
+        : _capacity(std::bit_ceil(std::max(capacity, kMinBufferSize))), _mask(_capacity - 1),
+          _storage(std::make_unique_for_overwrite<u64[]>(_capacity / sizeof(u64))),
+          _data(RCAST<u8*>(_storage.get())), _thread(thread) {}
+
+    Logger::Logger(const LoggerConfig& config)
+        : _config(config), _startTime(Clock::now().time_since_epoch().count()) {
+        _level.store(config.level, std::memory_order_relaxed);
+        if (!config.filePath.empty()) {
+            _file = std::fopen(config.filePath.c_str(), "a");
+            if (!_file) { std::printf("Failed to open log file '%s'\n", config.filePath.c_str()); }
+        }
+        _writer = std::thread([this] { WriterLoop(); });
+    }
+
+    Logger::~Logger() {
+        _stopping.store(true);
+        {
+            std::lock_guard lock(_wakeMutex);
+        }
+        _wake.notify_all();
+        if (_writer.joinable()) { _writer.join(); }
+
+        DrainAll();
+        if (_file) { std::fclose(_file); }
+    }
+
+    Logger& Logger::Get() {
+        static Logger logger([] {
+            std::lock_guard lock(gSharedLoggerMutex);
+            return gSharedLoggerConfig;
+        }());
+        return logger;
+    }
+
+    void Logger::Configure(const LoggerConfig& config) {
+        std::lock_guard lock(gSharedLoggerMutex);
+        gSharedLoggerConfig = config;
+    }
+
+    void Logger::Flush() {
+        DrainAll();
+    }
+
+    LogBuffer* Logger::RegisterThread() {
+        // Hands the buffer back when the thread exits, so short-lived threads reuse rings instead
+        // of piling up new ones. Whatever it still holds gets drained by the next owner's passes.
+        struct Registration {
+            LogBuffer* buffer = None;
+
+            ~Registration() {
+                if (!buffer) { return; }
+                tBuffer = None;
+                buffer->_inUse.store(false, std::memory_order_release);
+            }
+        };
+        static thread_local Registration registration;
+
+        std::lock_guard lock(_buffersMutex);
+        LogBuffer* buffer = None;
+        for (const auto& candidate : _buffers) {
+            bool inUse = false;
+            if (candidate->_inUse.compare_exchange_strong(inUse, true, std::memory_order_acquire)) {
+                buffer = candidate.get();
+                break;
+            }
+        }
+        if (!buffer) {
+            const auto thread = CAST<u32>(_buffers.size());
+            _buffers.push_back(make_unique<LogBuffer>(_config.bufferSize, thread));
+            buffer = _buffers.back().get();
+        }
+
+        registration.buffer = buffer;
+        tBuffer             = buffer;
+        return buffer;
+    }
+
+    void Logger::WriterLoop() {
+        while (!_stopping.load()) {
+            {
+                std::unique_lock lock(_wakeMutex);
+                _wake.wait_for(lock, kDrainInterval, [this] { return _stopping.load(); });
+            }
+            DrainAll();
+        }
+    }
+
+    void Logger::DrainAll() {
+        std::lock_guard drainLock(_drainMutex);
+        {
+            std::lock_guard lock(_buffersMutex);
+            _draining.clear();
+            for (const auto& buffer : _buffers) {
+                _draining.push_back(buffer.get());
+            }
+        }
+
+        _text.clear();
+        _lines.clear();
+        char message[kMaxMessageLength];
+        const auto addLine = [&](const i64 timestamp,
+                                 const u32 thread,
+                                 const LogLevel level,
+                                 const LogSite* site,
+                                 const cstr text) {
+            const f64 seconds =
+              std::chrono::duration<f64>(Clock::duration(timestamp - _startTime)).count();
+            const size_t offset = _text.size();
+            AppendLine(_text, seconds, thread, level, site, text);
+            _lines.emplace_back(timestamp, offset, _text.size() - offset);
+        };
+
+        for (LogBuffer* buffer : _draining) {
+            buffer->Drain([&](const LogRecord& record, const u8* args) {
+                record.format(args, message, sizeof(message), record.site->format);
+                const LogSite* site = record.site;
+                addLine(record.timestamp, buffer->GetThread(), site->level, site, message);
+            });
+            if (const u64 dropped = buffer->TakeDropCount()) {
+                std::snprintf(message,
+                              sizeof(message),
+                              "Log buffer full, dropped %llu messages",
+                              CAST<unsigned long long>(dropped));
+                addLine(Clock::now().time_since_epoch().count(),
+                        buffer->GetThread(),
+                        LogLevel::Warn,
+                        None,
+                        message);
+            }
+        }
+        if (_lines.empty()) { return; }
+
+        // Each buffer is in order already, this interleaves the threads
+        std::stable_sort(_lines.begin(), _lines.end(), [](const auto& a, const auto& b) {
+            return std::get<0>(a) < std::get<0>(b);
+        });
+        for (const auto& [timestamp, offset, size] : _lines) {
+            if (_config.console) { std::fwrite(_text.data() + offset, 1, size, stdout); }
+            if (_file) { std::fwrite(_text.data() + offset, 1, size, _file); }
+        }
+        if (_config.console) { std::fflush(stdout); }
+        if (_file) { std::fflush(_file); }
+    }
+}  // namespace x
@@ -0,0 +1,507 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Types.hpp"
+#include "Queue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+
+/// Lowest level compiled in: 0 Trace, 1 Debug, 2 Info, 3 Warn, 4 Error. Calls below it expand to
+/// nothing. Fatal (Panic) is never stripped.
+#ifndef XEN_LOG_LEVEL
+    #ifdef NDEBUG
+        #define XEN_LOG_LEVEL 2
+    #else
+        #define XEN_LOG_LEVEL 0
+    #endif
+#endif
+
+namespace x {
+    enum class LogLevel : u8 { Trace, Debug, Info, Warn, Error, Fatal };
+
+    inline constexpr auto kMinLogLevel = CAST<LogLevel>(XEN_LOG_LEVEL);
+
+    constexpr bool IsLogLevelCompiled(const LogLevel level) {
+        return level >= kMinLogLevel || level == LogLevel::Fatal;
+    }
+
+    /// Everything known about a log statement at compile time. Each one is a static, so its
+    /// address is the message ID a record carries instead of the formatted text.
+    struct LogSite {
+        LogLevel level;
+        cstr format;  // printf-style
+        cstr file;
+        i32 line;
+        cstr function;
+    };
+
+    struct LoggerConfig {
+        LogLevel level    = LogLevel::Trace;  // Runtime filter on top of XEN_LOG_LEVEL
+        str filePath;                         // Also append to this file, if set
+        bool console      = true;
+        size_t bufferSize = 1 << 16;  // Per logging thread
+    };
+
+    /// Header of a record in a LogBuffer, followed by the encoded arguments.
+    struct LogRecord {
+        using FormatFunc = i32 (*)(const u8* args, char* out, size_t size, cstr format);
+
+        u32 size;  // Including the header and padding
+        const LogSite* site;  // None marks padding up to the end of the ring
+        FormatFunc format;
+        i64 timestamp;  // steady_clock ticks
+    };
+
+    template<typename T>
+    inline constexpr bool kIsLogString = std::is_same_v<T, cstr> || std::is_same_v<T, char*> ||
+                                         std::is_same_v<T, str> ||
+                                         std::is_same_v<T, std::string_view>;
+
+    // Not constexpr, so a LogFormat that reaches it fails to compile, naming the reason
+    inline void LogFormatError(cstr) {}
+
+    /// printf-style format string checked against the argument types at compile time, the way
+    /// std::format_string is for std::format. Integer conversions must match the argument's size
+    /// after promotion (`%d` for int and smaller, `%zu`, `%lld` and friends for 64-bit), `%s`
+    /// takes a string and `%p` any other pointer.
+    template<typename... Args>
+    class LogFormat {
+    public:
+        // Implicit, so call sites pass the literal as is
+        consteval LogFormat(const cstr format) {
+            size_t next = 0;
+            for (cstr c = format; *c; c++) {
+                if (*c != '%') { continue; }
+                if (*++c == '%') { continue; }
+
+                while (*c == '-' || *c == '+' || *c == ' ' || *c == '#' || *c == '0') {
+                    c++;
+                }
+                c = SkipWidth(c, next);
+                if (*c == '.') { c = SkipWidth(c + 1, next); }
+
+                size_t size     = sizeof(int);  // hh and h are promoted to int too
+                bool longDouble = false;
+                if (*c == 'h') {
+                    c += c[1] == 'h' ? 2 : 1;
+                } else if (*c == 'l') {
+                    size = c[1] == 'l' ? sizeof(long long) : sizeof(long);
+                    c += c[1] == 'l' ? 2 : 1;
+                } else if (*c == 'j') {
+                    size = sizeof(intmax_t);
+                    c++;
+                } else if (*c == 'z' || *c == 't') {
+                    size = *c == 'z' ? sizeof(size_t) : sizeof(ptrdiff_t);
+                    c++;
+                } else if (*c == 'L') {
+                    longDouble = true;
+                    c++;
+                }
+
+                if (*c == '\0') {
+                    LogFormatError("Format ends in the middle of a conversion");
+                    return;
+                }
+                if (next == kArgs.size()) {
+                    LogFormatError("Format has more conversions than arguments");
+                    return;
+                }
+                const ArgInfo arg = kArgs[next++];
+                switch (*c) {
+                    case 'd':
+                    case 'i':
+                    case 'o':
+                    case 'u':
+                    case 'x':
+                    case 'X':
+                    case 'c':
+                        if (arg.kind != Kind::Integer || arg.size != size) {
+                            LogFormatError("Integer conversion doesn't match the argument");
+                        }
+                        break;
+                    case 'f':
+                    case 'F':
+                    case 'e':
+                    case 'E':
+                    case 'g':
+                    case 'G':
+                    case 'a':
+                    case 'A':
+                        if (arg.kind != Kind::Floating ||
+                            (arg.size == sizeof(long double)) != longDouble) {
+                            LogFormatError("Floating-point conversion doesn't match the argument");
+                        }
+                        break;
+                    case 's':
+                        if (arg.kind != Kind::String) { LogFormatError("%s needs a string"); }
+                        break;
+                    case 'p':
+                        if (arg.kind != Kind::Pointer) { LogFormatError("%p needs a pointer"); }
+                        break;
+                    default:
+                        LogFormatError("Unsupported conversion");
+                }
+            }
+            if (next != kArgs.size()) {
+                LogFormatError("Format has fewer conversions than arguments");
+            }
+        }
+
+    private:
+        enum class Kind : u8 { Integer, Floating, String, Pointer };
+
+        struct ArgInfo {
+            Kind kind;
+            size_t size;  // After default argument promotion
+        };
+
+        template<typename T>
+        static consteval ArgInfo Describe() {
+            if constexpr (kIsLogString<T>) {
+                return {Kind::String, 0};
+            } else if constexpr (std::is_floating_point_v<T>) {
+                return {Kind::Floating, std::max(sizeof(T), sizeof(double))};
+            } else if constexpr (std::is_pointer_v<T>) {
+                return {Kind::Pointer, sizeof(T)};
+            } else {
+                static_assert(std::is_integral_v<T> || std::is_enum_v<T>,
+                              "Unsupported log argument type");
+                return {Kind::Integer, std::max(sizeof(T), sizeof(int))};
+            }
+        }
+
+        // Skips a width or precision, checking that a `*` has an int argument to take
+        static consteval cstr SkipWidth(cstr c, size_t& next) {
+            if (*c == '*') {
+                if (next == kArgs.size() || kArgs[next].kind != Kind::Integer ||
+                    kArgs[next].size != sizeof(int)) {
+                    LogFormatError("`*` needs an int argument");
+                }
+                next++;
+                return c + 1;
+            }
+            while (*c >= '0' && *c <= '9') {
+                c++;
+            }
+            return c;
+        }
+
+        static constexpr std::array<ArgInfo, sizeof...(Args)> kArgs {
+          Describe<std::decay_t<Args>>()...};
+    };
+
+    /// Byte ring one thread writes records into and the logger thread drains. Records never wrap;
+    /// if one doesn't fit before the end, the rest of the ring is skipped.
+    class LogBuffer {
+    public:
+        LogBuffer(size_t capacity, u32 thread);
+
+        LogBuffer(const LogBuffer&)            = delete;
+        LogBuffer& operator=(const LogBuffer&) = delete;
+
+        /// Producer only. Returns where to write a `size`-byte record, or None if it doesn't fit.
+        u8* Reserve(const size_t size) {
+            const u64 head      = _head.load(std::memory_order_relaxed);
+            const size_t offset = head & _mask;
+            const size_t skip   = offset + size > _capacity ? _capacity - offset : 0;
+            if (size + skip > _capacity - (head - _cachedTail)) {
+                _cachedTail = _tail.load(std::memory_order_acquire);
+                if (size + skip > _capacity - (head - _cachedTail)) { return None; }
+            }
+            if (skip >= sizeof(LogRecord)) {
+                new (_data + offset) LogRecord {CAST<u32>(skip), None, None, 0};
+            }
+            _reserved = head + skip;
+            return _data + (_reserved & _mask);
+        }
+
+        /// Producer only. Publishes the record returned by the last Reserve().
+        void Commit(const size_t size) {
+            _head.store(_reserved + size, std::memory_order_release);
+        }
+
+        void CountDrop() {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /// Consumer only. Calls `func(record, args)` for every published record, then frees them.
+        template<typename Func>
+        void Drain(Func&& func) {
+            const u64 head = _head.load(std::memory_order_acquire);
+            u64 tail       = _tail.load(std::memory_order_relaxed);
+            while (tail != head) {
+                const size_t offset = tail & _mask;
+                if (_capacity - offset < sizeof(LogRecord)) {
+                    tail += _capacity - offset;
+                    continue;
+                }
+                const auto* record = RCAST<const LogRecord*>(_data + offset);
+                if (record->site) { func(*record, _data + offset + sizeof(LogRecord)); }
+                tail += record->size;
+            }
+            _tail.store(tail, std::memory_order_release);
+        }
+
+        [[nodiscard]] u64 TakeDropCount() {
+            return _dropped.exchange(0, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] size_t Capacity() const {
+            return _capacity;
+        }
+
+        [[nodiscard]] u32 GetThread() const {
+            return _thread;
+        }
+
+    private:
+        friend class Logger;
+
+        const size_t _capacity;
+        const size_t _mask;
+        const unique_ptr<u64[]> _storage;  // u64 so records stay 8-byte aligned
+        u8* const _data;
+        const u32 _thread;
+
+        alignas(kCacheLineSize) std::atomic<u64> _head {0};
+        u64 _cachedTail = 0;
+        u64 _reserved   = 0;
+        std::atomic<u64> _dropped {0};
+
+        alignas(kCacheLineSize) std::atomic<u64> _tail {0};
+        std::atomic<bool> _inUse {true};  // Cleared when the writing thread exits
+    };
+
+    /// Asynchronous logger. The calling thread only copies the arguments next to the address of
+    /// the statement's LogSite into its own ring buffer; a background thread formats, orders by
+    /// time and writes everything out every few milliseconds. When a thread's ring is full,
+    /// Trace to Info messages are dropped and counted, Warn and up flush it once and retry.
+    ///
+    /// Arguments can be arithmetic types, enums, pointers and strings (cstr, str, string_view).
+    /// Strings are copied, up to kMaxStringLength bytes. A record never takes more than half the
+    /// ring, so it always fits once the ring is drained; longer strings are cut to make it fit.
+    class Logger {
+    public:
+        static constexpr size_t kMaxStringLength = 1024;
+
+        ~Logger();
+
+        Logger(const Logger&)            = delete;
+        Logger& operator=(const Logger&) = delete;
+
+        /// Returns the process-wide logger, creating it on first use.
+        static Logger& Get();
+        /// Sets the config used to create the shared logger. Has no effect once Get() was called.
+        static void Configure(const LoggerConfig& config);
+
+        static void SetLevel(const LogLevel level) {
+            _level.store(level, std::memory_order_relaxed);
+        }
+
+        /// `format` is the site's format, passed again so it gets checked against `args`.
+        template<typename... Args>
+        static void Write(const LogSite& site,
+                          LogFormat<std::type_identity_t<Args>...> format,
+                          const Args&... args) {
+            (void)format;
+            if (site.level < _level.load(std::memory_order_relaxed)) { return; }
+            LogBuffer* buffer = tBuffer;
+            if (!buffer) { buffer = Get().RegisterThread(); }
+
+            size_t maxString  = kMaxStringLength;
+            size_t size       = RecordSize(maxString, args...);
+            const size_t half = buffer->Capacity() / 2;
+            if (size > half) {
+                constexpr size_t strings = (size_t {0} + ... + kIsLogString<std::decay_t<Args>>);
+                const size_t fixed       = RecordSize(0, args...);
+                if (strings == 0 || fixed > half) {
+                    buffer->CountDrop();
+                    return;
+                }
+                maxString = (half - fixed) / strings;
+                size      = RecordSize(maxString, args...);
+            }
+
+            u8* out = buffer->Reserve(size);
+            if (!out && site.level >= LogLevel::Warn) {
+                // Only this thread writes to the ring, so it's empty after the flush
+                Get().Flush();
+                out = buffer->Reserve(size);
+            }
+            if (!out) {
+                buffer->CountDrop();
+                return;
+            }
+
+            new (out) LogRecord {CAST<u32>(size),
+                                 &site,
+                                 &FormatArgs<std::decay_t<Args>...>,
+                                 std::chrono::steady_clock::now().time_since_epoch().count()};
+            [[maybe_unused]] u8* cursor = out + sizeof(LogRecord);
+            (EncodeArg(cursor, maxString, args), ...);
+            buffer->Commit(size);
+        }
+
+        /// Writes out everything logged so far, from every thread, before returning.
+        void Flush();
+
+    private:
+        explicit Logger(const LoggerConfig& config);
+
+        template<typename T>
+        static auto StoredType() {
+            if constexpr (std::is_enum_v<T>) {
+                return std::underlying_type_t<T> {};
+            } else if constexpr (std::is_pointer_v<T>) {
+                return CAST<const void*>(None);
+            } else {
+                return T {};
+            }
+        }
+
+        // What an argument is stored and passed to printf as
+        template<typename T>
+        using Stored = decltype(StoredType<T>());
+
+        template<typename T>
+        static std::string_view AsString(const T& value) {
+            if constexpr (std::is_pointer_v<T>) {
+                return value ? std::string_view(value) : std::string_view("(null)");
+            } else {
+                return std::string_view(value);
+            }
+        }
+
+        // Bytes a record takes with strings cut to `maxString`, rounded to keep records aligned
+        template<typename... Args>
+        static size_t RecordSize([[maybe_unused]] const size_t maxString, const Args&... args) {
+            const size_t argsSize = (size_t {0} + ... + ArgSize(maxString, args));
+            return (sizeof(LogRecord) + argsSize + 7) & ~size_t {7};
+        }
+
+        template<typename T>
+        static size_t ArgSize(const size_t maxString, const T& value) {
+            using Arg = std::decay_t<T>;
+            if constexpr (kIsLogString<Arg>) {
+                return sizeof(u32) + std::min(AsString(value).size(), maxString) + 1;
+            } else {
+                static_assert(std::is_arithmetic_v<Arg> || std::is_enum_v<Arg> ||
+                                std::is_pointer_v<Arg>,
+                              "Unsupported log argument type");
+                return sizeof(Stored<Arg>);
+            }
+        }
+
+        template<typename T>
+        static void EncodeArg(u8*& cursor, const size_t maxString, const T& value) {
+            using Arg = std::decay_t<T>;
+            if constexpr (kIsLogString<Arg>) {
+                const std::string_view text = AsString(value);
+                const auto length           = CAST<u32>(std::min(text.size(), maxString));
+                std::memcpy(cursor, &length, sizeof(length));
+                std::memcpy(cursor + sizeof(length), text.data(), length);
+                cursor[sizeof(length) + length] = '\0';
+                cursor += sizeof(length) + length + 1;
+            } else {
+                const auto stored = CAST<Stored<Arg>>(value);
+                std::memcpy(cursor, &stored, sizeof(stored));
+                cursor += sizeof(stored);
+            }
+        }
+
+        template<typename Arg>
+        static auto DecodeArg(const u8*& cursor) {
+            if constexpr (kIsLogString<Arg>) {
+                u32 length;
+                std::memcpy(&length, cursor, sizeof(length));
+                const auto text = RCAST<cstr>(cursor + sizeof(length));
+                cursor += sizeof(length) + length + 1;
+                return text;
+            } else {
+                Stored<Arg> value;
+                std::memcpy(&value, cursor, sizeof(value));
+                cursor += sizeof(value);
+                return value;
+            }
+        }
+
+        // Instantiated per argument list, runs on the logger thread
+        template<typename... Args>
+        static i32 FormatArgs(const u8* args, char* out, const size_t size, const cstr format) {
+            if constexpr (sizeof...(Args) == 0) {
+                // LogFormat let only `%%` through, so there's nothing to format but those
+                size_t length = 0;
+                for (cstr c = format; *c && length + 1 < size; c++) {
+                    if (c[0] == '%' && c[1] == '%') { c++; }
+                    out[length++] = *c;
+                }
+                out[length] = '\0';
+                return CAST<i32>(length);
+            } else {
+                const u8* cursor = args;
+                // Braced init, so the arguments are decoded left to right
+                const std::tuple<decltype(DecodeArg<Args>(cursor))...> values {
+                  DecodeArg<Args>(cursor)...};
+                return std::apply(
+                  [&](const auto&... value) { return std::snprintf(out, size, format, value...); },
+                  values);
+            }
+        }
+
+        LogBuffer* RegisterThread();
+        void WriterLoop();
+        void DrainAll();
+
+        static inline std::atomic<LogLevel> _level {LogLevel::Trace};
+        static inline thread_local LogBuffer* tBuffer = None;
+
+        LoggerConfig _config;
+        std::FILE* _file = None;
+        const i64 _startTime;
+
+        std::mutex _buffersMutex;
+        vector<unique_ptr<LogBuffer>> _buffers;
+
+        std::mutex _drainMutex;        // Held while draining, the buffers have a single consumer
+        vector<LogBuffer*> _draining;  // Reused by every drain, like the two below
+        str _text;
+        vector<std::tuple<i64, size_t, size_t>> _lines;  // Timestamp, offset and size in _text
+
+        std::thread _writer;
+        std::atomic<bool> _stopping {false};
+        std::mutex _wakeMutex;
+        std::condition_variable _wake;
+    };
+}  // namespace x
+
+#define XEN_LOG(level, fmt, ...)                                                                   \
+    do {                                                                                           \
+        if constexpr (x::IsLogLevelCompiled(level)) {                                              \
+            static constexpr x::LogSite _xenLogSite {                                              \
+              level, fmt, __FILE__, __LINE__, __FUNCTION__};                                       \
+            x::Logger::Write(_xenLogSite, fmt, ##__VA_ARGS__);                                     \
+        }                                                                                          \
+    } while (false)
+
+#define LogTrace(fmt, ...) XEN_LOG(x::LogLevel::Trace, fmt, ##__VA_ARGS__)
+#define LogDebug(fmt, ...) XEN_LOG(x::LogLevel::Debug, fmt, ##__VA_ARGS__)
+#define LogInfo(fmt, ...) XEN_LOG(x::LogLevel::Info, fmt, ##__VA_ARGS__)
+#define LogWarn(fmt, ...) XEN_LOG(x::LogLevel::Warn, fmt, ##__VA_ARGS__)
+#define LogError(fmt, ...) XEN_LOG(x::LogLevel::Error, fmt, ##__VA_ARGS__)
@@ -4,22 +4,22 @@
 
 #pragma once
 
-#include <cstdarg>
-#include <cstdio>
+#include <cstdlib>
 #include "Types.hpp"
+#include "Log.hpp"
 
 namespace x {
-    [[noreturn]] static void __panic_impl(cstr file, i32 line, cstr func, cstr fmt, ...) noexcept {
-        va_list args;
-        va_start(args, fmt);
-        char message[1024];
-        vsnprintf(message, sizeof(message), fmt, args);
-        va_end(args);
-        printf("%s:%d :: PANIC\n -- In function: `%s`\n -- Error: %s\n", file, line, func, message);
+    /// Writes out the log, the panic message included, before aborting.
+    [[noreturn]] static void __panic_impl() noexcept {
+        Logger::Get().Flush();
         std::abort();
     }
 
 #ifndef PANIC
-    #define Panic(fmt, ...) x::__panic_impl(__FILE__, __LINE__, __FUNCTION__, fmt, ##__VA_ARGS__)
+    #define Panic(fmt, ...)                                                                        \
+        do {                                                                                       \
+            XEN_LOG(x::LogLevel::Fatal, fmt, ##__VA_ARGS__);                                       \
+            x::__panic_impl();                                                                     \
+        } while (false)
 #endif
-}  // namespace x
\ No newline at end of file
+}  // namespace x
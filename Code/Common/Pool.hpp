@@ -0,0 +1,111 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Types.hpp"
+#include "Panic.inl"
+
+#include <new>
+#include <utility>
+
+namespace x {
+    /// Fixed-size object pool. Objects live in chunks of `ChunkSize` slots that are never moved
+    /// or freed until the pool dies, so pointers stay valid until Destroy() and a churn of
+    /// create/destroy reuses slots instead of hitting the heap. Not thread-safe.
+    template<typename T, size_t ChunkSize = 64>
+    class Pool {
+    public:
+        static_assert(ChunkSize > 0);
+
+        Pool() = default;
+
+        ~Pool() {
+            Clear();
+        }
+
+        Pool(const Pool&)            = delete;
+        Pool& operator=(const Pool&) = delete;
+
+        template<typename... Args>
+        T* Create(Args&&... args) {
+            if (!_freeList) { AddChunk(); }
+            Slot* slot = _freeList;
+            T* object  = new (slot->storage) T(std::forward<Args>(args)...);
+            _freeList  = slot->nextFree;
+            slot->live = true;
+            _size++;
+            return object;
+        }
+
+        /// Destroys an object created by this pool and frees its slot for reuse.
+        void Destroy(T* object) {
+            if (!object) { return; }
+            Slot* slot = RCAST<Slot*>(object);
+            if (!slot->live) { Panic("Pool object destroyed twice."); }
+            object->~T();
+            slot->live     = false;
+            slot->nextFree = _freeList;
+            _freeList      = slot;
+            _size--;
+        }
+
+        /// Destroys every live object. The chunks are kept for reuse.
+        void Clear() {
+            _freeList = None;
+            for (auto chunk = _chunks.rbegin(); chunk != _chunks.rend(); ++chunk) {
+                for (size_t i = ChunkSize; i-- > 0;) {
+                    Slot& slot = (*chunk)[i];
+                    if (slot.live) {
+                        RCAST<T*>(slot.storage)->~T();
+                        slot.live = false;
+                    }
+                    slot.nextFree = _freeList;
+                    _freeList     = &slot;
+                }
+            }
+            _size = 0;
+        }
+
+        /// Calls `func` on every live object, in memory order.
+        template<typename Func>
+        void ForEach(Func&& func) {
+            for (auto& chunk : _chunks) {
+                for (size_t i = 0; i < ChunkSize; i++) {
+                    if (chunk[i].live) { func(*RCAST<T*>(chunk[i].storage)); }
+                }
+            }
+        }
+
+        [[nodiscard]] size_t Size() const {
+            return _size;
+        }
+
+        [[nodiscard]] size_t Capacity() const {
+            return _chunks.size() * ChunkSize;
+        }
+
+    private:
+        struct Slot {
+            // First member, so a T* handed out by Create() is also the address of its slot
+            alignas(T) u8 storage[sizeof(T)];
+            Slot* nextFree = None;
+            bool live      = false;
+        };
+
+        void AddChunk() {
+            auto chunk = make_unique<Slot[]>(ChunkSize);
+            // Thread the free list front to back, so new objects fill the chunk in order
+            for (size_t i = ChunkSize; i-- > 0;) {
+                chunk[i].nextFree = _freeList;
+                _freeList         = &chunk[i];
+            }
+            _chunks.push_back(std::move(chunk));
+        }
+
+        vector<unique_ptr<Slot[]>> _chunks;
+        Slot* _freeList = None;
+        size_t _size    = 0;
+    };
+}  // namespace x
@@ -0,0 +1,282 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Types.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <new>
+#include <span>
+#include <utility>
+
+namespace x {
+    /// Assumed cache line size. std::hardware_destructive_interference_size isn't usable in
+    /// headers on GCC without an ABI warning, and 64 holds on every target we ship.
+    inline constexpr size_t kCacheLineSize = 64;
+
+    /// Bounded lock-free queue for exactly one producer thread and one consumer thread. The
+    /// capacity is rounded up to a power of two. Each side keeps a cached copy of the other
+    /// side's index, so an uncontended push or pop doesn't touch the other thread's cache line.
+    template<typename T>
+    class SpscQueue {
+    public:
+        explicit SpscQueue(const size_t capacity)
+            : _capacity(std::bit_ceil(std::max<size_t>(capacity, 2))), _mask(_capacity - 1),
+              _storage(std::make_unique_for_overwrite<Storage[]>(_capacity)) {}
+
+        ~SpscQueue() {
+            for (size_t i = _tail.load(std::memory_order_relaxed);
+                 i != _head.load(std::memory_order_relaxed);
+                 i++) {
+                Slot(i)->~T();
+            }
+        }
+
+        SpscQueue(const SpscQueue&)            = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        /// Producer only. Returns false if the queue is full.
+        template<typename... Args>
+        bool TryEmplace(Args&&... args) {
+            const size_t head = _head.load(std::memory_order_relaxed);
+            if (head - _cachedTail == _capacity) {
+                _cachedTail = _tail.load(std::memory_order_acquire);
+                if (head - _cachedTail == _capacity) { return false; }
+            }
+            new (Slot(head)) T(std::forward<Args>(args)...);
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool TryPush(T&& value) {
+            return TryEmplace(std::move(value));
+        }
+
+        bool TryPush(const T& value) {
+            return TryEmplace(value);
+        }
+
+        /// Producer only. Moves as many of `items` as fit, in order, and publishes them together.
+        /// Returns how many were pushed.
+        size_t TryPushBatch(std::span<T> items) {
+            const size_t head = _head.load(std::memory_order_relaxed);
+            if (_capacity - (head - _cachedTail) < items.size()) {
+                _cachedTail = _tail.load(std::memory_order_acquire);
+            }
+            const size_t count = std::min(items.size(), _capacity - (head - _cachedTail));
+            for (size_t i = 0; i < count; i++) {
+                new (Slot(head + i)) T(std::move(items[i]));
+            }
+            if (count > 0) { _head.store(head + count, std::memory_order_release); }
+            return count;
+        }
+
+        /// Consumer only. Returns false if the queue is empty.
+        bool TryPop(T& out) {
+            const size_t tail = _tail.load(std::memory_order_relaxed);
+            if (tail == _cachedHead) {
+                _cachedHead = _head.load(std::memory_order_acquire);
+                if (tail == _cachedHead) { return false; }
+            }
+            T* item = Slot(tail);
+            out     = std::move(*item);
+            item->~T();
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// Consumer only. Pops up to `out.size()` items into `out` and frees their slots together.
+        /// Returns how many were popped.
+        size_t TryPopBatch(std::span<T> out) {
+            const size_t tail = _tail.load(std::memory_order_relaxed);
+            if (_cachedHead - tail < out.size()) {
+                _cachedHead = _head.load(std::memory_order_acquire);
+            }
+            const size_t count = std::min(out.size(), _cachedHead - tail);
+            for (size_t i = 0; i < count; i++) {
+                T* item = Slot(tail + i);
+                out[i]  = std::move(*item);
+                item->~T();
+            }
+            if (count > 0) { _tail.store(tail + count, std::memory_order_release); }
+            return count;
+        }
+
+        /// Only exact while neither side is running.
+        [[nodiscard]] size_t SizeApprox() const {
+            return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] size_t Capacity() const {
+            return _capacity;
+        }
+
+    private:
+        struct Storage {
+            alignas(T) u8 bytes[sizeof(T)];
+        };
+
+        T* Slot(const size_t index) const {
+            return std::launder(RCAST<T*>(_storage[index & _mask].bytes));
+        }
+
+        const size_t _capacity;
+        const size_t _mask;
+        const unique_ptr<Storage[]> _storage;
+
+        alignas(kCacheLineSize) std::atomic<size_t> _head {0};  // Next slot to fill
+        size_t _cachedTail = 0;                                 // Producer's view of _tail
+
+        alignas(kCacheLineSize) std::atomic<size_t> _tail {0};  // Next slot to drain
+        size_t _cachedHead = 0;                                 // Consumer's view of _head
+    };
+
+    /// Bounded lock-free queue for any number of producers and consumers (Vyukov's design): every
+    /// cell carries a sequence number that says whose turn it is, so a push or pop is one CAS on
+    /// the shared index plus a store to the cell. The capacity is rounded up to a power of two.
+    template<typename T>
+    class MpmcQueue {
+    public:
+        explicit MpmcQueue(const size_t capacity)
+            : _capacity(std::bit_ceil(std::max<size_t>(capacity, 2))), _mask(_capacity - 1),
+              _cells(make_unique<Cell[]>(_capacity)) {
+            for (size_t i = 0; i < _capacity; i++) {
+                _cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        ~MpmcQueue() {
+            const size_t end = _enqueuePos.load(std::memory_order_relaxed);
+            for (size_t pos = _dequeuePos.load(std::memory_order_relaxed); pos != end; pos++) {
+                Cell& cell = _cells[pos & _mask];
+                if (cell.sequence.load(std::memory_order_relaxed) == pos + 1) { cell.Get()->~T(); }
+            }
+        }
+
+        MpmcQueue(const MpmcQueue&)            = delete;
+        MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+        /// Returns false if the queue is full.
+        template<typename... Args>
+        bool TryEmplace(Args&&... args) {
+            size_t pos;
+            if (ClaimRange(_enqueuePos, 0, 1, pos) == 0) { return false; }
+            Cell& cell = _cells[pos & _mask];
+            new (cell.storage) T(std::forward<Args>(args)...);
+            cell.sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool TryPush(T&& value) {
+            return TryEmplace(std::move(value));
+        }
+
+        bool TryPush(const T& value) {
+            return TryEmplace(value);
+        }
+
+        /// Claims a run of free cells with a single CAS and moves as many of `items` into them as
+        /// there were. Returns how many were pushed.
+        size_t TryPushBatch(std::span<T> items) {
+            size_t pos;
+            const size_t count = ClaimRange(_enqueuePos, 0, items.size(), pos);
+            for (size_t i = 0; i < count; i++) {
+                Cell& cell = _cells[(pos + i) & _mask];
+                new (cell.storage) T(std::move(items[i]));
+                cell.sequence.store(pos + i + 1, std::memory_order_release);
+            }
+            return count;
+        }
+
+        /// Returns false if the queue is empty.
+        bool TryPop(T& out) {
+            size_t pos;
+            if (ClaimRange(_dequeuePos, 1, 1, pos) == 0) { return false; }
+            Release(pos, out);
+            return true;
+        }
+
+        /// Claims a run of filled cells with a single CAS and pops them into `out`. Returns how
+        /// many were popped.
+        size_t TryPopBatch(std::span<T> out) {
+            size_t pos;
+            const size_t count = ClaimRange(_dequeuePos, 1, out.size(), pos);
+            for (size_t i = 0; i < count; i++) {
+                Release(pos + i, out[i]);
+            }
+            return count;
+        }
+
+        /// Only exact while nothing is pushing or popping.
+        [[nodiscard]] size_t SizeApprox() const {
+            const size_t tail = _dequeuePos.load(std::memory_order_acquire);
+            const size_t head = _enqueuePos.load(std::memory_order_acquire);
+            return head > tail ? head - tail : 0;
+        }
+
+        [[nodiscard]] size_t Capacity() const {
+            return _capacity;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            alignas(T) u8 storage[sizeof(T)];
+
+            T* Get() {
+                return std::launder(RCAST<T*>(storage));
+            }
+        };
+
+        // Claims up to `max` consecutive positions from `index` whose cells are ready, i.e. whose
+        // sequence is the position plus `lag` (0 for producers, 1 for consumers). Only the
+        // thread that wins the CAS can touch a ready cell next, so checking before the CAS is
+        // enough. Returns the number claimed and the first position in `first`.
+        size_t ClaimRange(std::atomic<size_t>& index,
+                          const size_t lag,
+                          const size_t max,
+                          size_t& first) {
+            if (max == 0) { return 0; }
+            size_t pos = index.load(std::memory_order_relaxed);
+            for (;;) {
+                size_t ready = 0;
+                while (ready < max && _cells[(pos + ready) & _mask].sequence.load(
+                                        std::memory_order_acquire) == pos + ready + lag) {
+                    ready++;
+                }
+
+                if (ready == 0) {
+                    const size_t sequence =
+                      _cells[pos & _mask].sequence.load(std::memory_order_acquire);
+                    // Behind the index means full (producers) or empty (consumers)
+                    if (CAST<std::ptrdiff_t>(sequence - (pos + lag)) < 0) { return 0; }
+                    pos = index.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (index.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed)) {
+                    first = pos;
+                    return ready;
+                }
+            }
+        }
+
+        void Release(const size_t pos, T& out) {
+            Cell& cell = _cells[pos & _mask];
+            T* item    = cell.Get();
+            out        = std::move(*item);
+            item->~T();
+            cell.sequence.store(pos + _capacity, std::memory_order_release);
+        }
+
+        const size_t _capacity;
+        const size_t _mask;
+        const unique_ptr<Cell[]> _cells;
+
+        alignas(kCacheLineSize) std::atomic<size_t> _enqueuePos {0};
+        alignas(kCacheLineSize) std::atomic<size_t> _dequeuePos {0};
+    };
+}  // namespace x
@@ -0,0 +1,103 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Types.hpp"
+
+#include <optional>
+#include <utility>
+#include <variant>
+
+namespace x {
+    /// Wraps an error so constructing a Result from it is unambiguous, even when T and E are
+    /// the same type.
+    template<typename E>
+    struct Unexpected {
+        E error;
+    };
+
+    template<typename E>
+    Unexpected(E) -> Unexpected<E>;
+
+    /// Either a value or an error, in the spirit of std::expected (which C++20 doesn't have).
+    /// Value() on an error and Error() on a value throw.
+    template<typename T, typename E>
+    class Result {
+    public:
+        Result(const T& value) : _storage(std::in_place_index<0>, value) {}
+        Result(T&& value) : _storage(std::in_place_index<0>, std::move(value)) {}
+        Result(Unexpected<E> error) : _storage(std::in_place_index<1>, std::move(error.error)) {}
+
+        [[nodiscard]] bool HasValue() const {
+            return _storage.index() == 0;
+        }
+
+        explicit operator bool() const {
+            return HasValue();
+        }
+
+        [[nodiscard]] T& Value() & {
+            return std::get<0>(_storage);
+        }
+        [[nodiscard]] const T& Value() const& {
+            return std::get<0>(_storage);
+        }
+        [[nodiscard]] T&& Value() && {
+            return std::get<0>(std::move(_storage));
+        }
+
+        [[nodiscard]] const E& Error() const {
+            return std::get<1>(_storage);
+        }
+
+        template<typename U>
+        [[nodiscard]] T ValueOr(U&& fallback) const& {
+            return HasValue() ? Value() : CAST<T>(std::forward<U>(fallback));
+        }
+        template<typename U>
+        [[nodiscard]] T ValueOr(U&& fallback) && {
+            return HasValue() ? std::move(*this).Value() : CAST<T>(std::forward<U>(fallback));
+        }
+
+        T& operator*() & {
+            return Value();
+        }
+        const T& operator*() const& {
+            return Value();
+        }
+        T* operator->() {
+            return &Value();
+        }
+        const T* operator->() const {
+            return &Value();
+        }
+
+    private:
+        std::variant<T, E> _storage;
+    };
+
+    /// Result of an operation that has nothing to return besides success.
+    template<typename E>
+    class Result<void, E> {
+    public:
+        Result() = default;
+        Result(Unexpected<E> error) : _error(std::move(error.error)) {}
+
+        [[nodiscard]] bool HasValue() const {
+            return !_error.has_value();
+        }
+
+        explicit operator bool() const {
+            return HasValue();
+        }
+
+        [[nodiscard]] const E& Error() const {
+            return _error.value();
+        }
+
+    private:
+        std::optional<E> _error;
+    };
+}  // namespace x
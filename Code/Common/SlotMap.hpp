@@ -0,0 +1,148 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Types.hpp"
+
+#include <limits>
+#include <utility>
+
+namespace x {
+    /// Handle into a SlotMap<T>: a slot index plus the generation the slot had when the value
+    /// was inserted. Removing the value bumps the generation, so stale handles stop resolving
+    /// instead of aliasing whatever moves into the slot next. A default handle is never valid.
+    template<typename T>
+    struct SlotHandle {
+        u32 index      = 0;
+        u32 generation = 0;
+
+        [[nodiscard]] bool IsNull() const {
+            return generation == 0;
+        }
+
+        bool operator==(const SlotHandle&) const = default;
+    };
+
+    /// Values stored densely in one array, addressed through generational handles. Lookups are
+    /// O(1) and validated, iteration walks contiguous memory, and removal swaps the last value
+    /// into the hole, so iteration order isn't insertion order and pointers into the map are
+    /// only good until the next insert or remove. Not thread-safe.
+    template<typename T>
+    class SlotMap {
+    public:
+        using Handle = SlotHandle<T>;
+
+        template<typename... Args>
+        Handle Emplace(Args&&... args) {
+            _values.emplace_back(std::forward<Args>(args)...);
+
+            u32 index;
+            if (_freeHead != kNoSlot) {
+                index     = _freeHead;
+                _freeHead = _slots[index].next;
+            } else {
+                index = CAST<u32>(_slots.size());
+                _slots.push_back({});
+            }
+            Slot& slot = _slots[index];
+            slot.next  = CAST<u32>(_values.size() - 1);
+            _dense.push_back(index);
+            return {index, slot.generation};
+        }
+
+        Handle Insert(T value) {
+            return Emplace(std::move(value));
+        }
+
+        /// Destroys the value behind `handle`. Returns false if the handle was already stale.
+        bool Remove(const Handle handle) {
+            if (!Contains(handle)) { return false; }
+            Slot& slot      = _slots[handle.index];
+            const u32 dense = slot.next;
+            if (dense != _values.size() - 1) {
+                const u32 moved    = _dense.back();
+                _values[dense]     = std::move(_values.back());
+                _dense[dense]      = moved;
+                _slots[moved].next = dense;
+            }
+            _values.pop_back();
+            _dense.pop_back();
+
+            // A slot whose generation would wrap is retired, so no old handle can ever match it
+            if (++slot.generation != 0) {
+                slot.next = _freeHead;
+                _freeHead = handle.index;
+            }
+            return true;
+        }
+
+        [[nodiscard]] bool Contains(const Handle handle) const {
+            return handle.index < _slots.size() && handle.generation != 0 &&
+                   _slots[handle.index].generation == handle.generation;
+        }
+
+        /// The value behind `handle`, or None if the handle is stale.
+        [[nodiscard]] T* Get(const Handle handle) {
+            return Contains(handle) ? &_values[_slots[handle.index].next] : None;
+        }
+
+        [[nodiscard]] const T* Get(const Handle handle) const {
+            return Contains(handle) ? &_values[_slots[handle.index].next] : None;
+        }
+
+        /// Handle of the value at position `denseIndex` of the iteration order.
+        [[nodiscard]] Handle HandleAt(const size_t denseIndex) const {
+            const u32 index = _dense[denseIndex];
+            return {index, _slots[index].generation};
+        }
+
+        void Reserve(const size_t count) {
+            _values.reserve(count);
+            _dense.reserve(count);
+            _slots.reserve(count);
+        }
+
+        /// Removes every value. Outstanding handles all go stale.
+        void Clear() {
+            while (!_dense.empty()) {
+                Remove(HandleAt(_dense.size() - 1));
+            }
+        }
+
+        [[nodiscard]] size_t Size() const {
+            return _values.size();
+        }
+
+        [[nodiscard]] bool IsEmpty() const {
+            return _values.empty();
+        }
+
+        auto begin() {
+            return _values.begin();
+        }
+        auto end() {
+            return _values.end();
+        }
+        auto begin() const {
+            return _values.begin();
+        }
+        auto end() const {
+            return _values.end();
+        }
+
+    private:
+        static constexpr u32 kNoSlot = std::numeric_limits<u32>::max();
+
+        struct Slot {
+            u32 next       = kNoSlot;  // Index into _values while live, next free slot otherwise
+            u32 generation = 1;
+        };
+
+        vector<T> _values;   // Dense
+        vector<u32> _dense;  // Slot index of each value in _values
+        vector<Slot> _slots;
+        u32 _freeHead = kNoSlot;
+    };
+}  // namespace x
@@ -0,0 +1,31 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#include "Task.hpp"
+
+namespace x {
+    InlineExecutor& InlineExecutor::Get() {
+        static InlineExecutor executor;
+        return executor;
+    }
+
+    void FrameExecutor::Schedule(std::coroutine_handle<> handle) {
+        std::lock_guard lock(_mutex);
+        _pending.push_back(handle);
+    }
+
+    size_t FrameExecutor::RunPending() {
+        {
+            std::lock_guard lock(_mutex);
+            std::swap(_pending, _running);
+        }
+        // Resumed coroutines may schedule themselves again, which lands in _pending
+        for (const auto handle : _running) {
+            handle.resume();
+        }
+        const size_t count = _running.size();
+        _running.clear();
+        return count;
+    }
+}  // namespace x
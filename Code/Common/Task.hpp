@@ -0,0 +1,254 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Types.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace x {
+    /// Where a suspended coroutine continues.
+    class Executor {
+    public:
+        virtual ~Executor() = default;
+
+        /// Resumes `handle` later, on whichever thread the executor runs its work on.
+        virtual void Schedule(std::coroutine_handle<> handle) = 0;
+    };
+
+    /// Resumes right away, on the thread that scheduled the coroutine.
+    class InlineExecutor final : public Executor {
+    public:
+        static InlineExecutor& Get();
+
+        void Schedule(std::coroutine_handle<> handle) override {
+            handle.resume();
+        }
+    };
+
+    /// Holds coroutines until the owning thread calls RunPending(), e.g. once per frame on the
+    /// main thread, so they can touch state that belongs to that thread. Schedule() may be
+    /// called from any thread.
+    class FrameExecutor final : public Executor {
+    public:
+        void Schedule(std::coroutine_handle<> handle) override;
+
+        /// Resumes every coroutine scheduled before the call and returns how many there were.
+        /// Coroutines scheduled while it runs wait for the next call.
+        size_t RunPending();
+
+    private:
+        std::mutex _mutex;
+        vector<std::coroutine_handle<>> _pending;
+        vector<std::coroutine_handle<>> _running;  // Only touched by RunPending()
+    };
+
+    /// `co_await ResumeOn(executor)` moves the rest of the coroutine onto `executor`.
+    inline auto ResumeOn(Executor& executor) {
+        struct Awaiter {
+            Executor& executor;
+
+            bool await_ready() const noexcept {
+                return false;
+            }
+            void await_suspend(std::coroutine_handle<> handle) const {
+                executor.Schedule(handle);
+            }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter {executor};
+    }
+
+    template<typename T>
+    class Task;
+
+    // Shared by every Task<T>: remembers who is awaiting the task and resumes them when it ends
+    class TaskPromiseBase {
+    public:
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        auto final_suspend() noexcept {
+            return FinalAwaiter {};
+        }
+
+        void unhandled_exception() {
+            _exception = std::current_exception();
+        }
+
+        void SetContinuation(const std::coroutine_handle<> continuation) {
+            _continuation = continuation;
+        }
+
+    protected:
+        void RethrowIfFailed() const {
+            if (_exception) { std::rethrow_exception(_exception); }
+        }
+
+    private:
+        // Hands the thread straight to the awaiting coroutine, if any
+        struct FinalAwaiter {
+            bool await_ready() const noexcept {
+                return false;
+            }
+            template<typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+                const auto continuation = handle.promise()._continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+            void await_resume() const noexcept {}
+        };
+
+        std::coroutine_handle<> _continuation;
+        std::exception_ptr _exception;
+    };
+
+    template<typename T>
+    class TaskPromise final : public TaskPromiseBase {
+    public:
+        Task<T> get_return_object();
+
+        template<typename U>
+        void return_value(U&& value) {
+            _value.emplace(std::forward<U>(value));
+        }
+
+        T TakeResult() {
+            RethrowIfFailed();
+            return std::move(*_value);
+        }
+
+    private:
+        std::optional<T> _value;
+    };
+
+    template<>
+    class TaskPromise<void> final : public TaskPromiseBase {
+    public:
+        Task<void> get_return_object();
+
+        void return_void() {}
+
+        void TakeResult() const {
+            RethrowIfFailed();
+        }
+    };
+
+    /// Lazily started coroutine returning T. Nothing runs until the task is awaited, and the
+    /// awaiting coroutine continues on whichever thread the task finishes on, so chains hop
+    /// threads only where they `co_await ResumeOn()` or an I/O awaitable. Exceptions thrown in
+    /// the task are rethrown from the co_await.
+    template<typename T = void>
+    class [[nodiscard]] Task {
+    public:
+        using promise_type = TaskPromise<T>;
+        using Handle       = std::coroutine_handle<promise_type>;
+
+        Task() = default;
+        explicit Task(Handle handle) : _handle(handle) {}
+
+        ~Task() {
+            if (_handle) { _handle.destroy(); }
+        }
+
+        Task(const Task&)            = delete;
+        Task& operator=(const Task&) = delete;
+
+        Task(Task&& other) noexcept : _handle(std::exchange(other._handle, {})) {}
+
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                if (_handle) { _handle.destroy(); }
+                _handle = std::exchange(other._handle, {});
+            }
+            return *this;
+        }
+
+        [[nodiscard]] bool IsDone() const {
+            return !_handle || _handle.done();
+        }
+
+        auto operator co_await() && noexcept {
+            struct Awaiter {
+                Handle handle;
+
+                bool await_ready() const noexcept {
+                    return !handle || handle.done();
+                }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                    handle.promise().SetContinuation(awaiting);
+                    return handle;  // Start the task without growing the stack
+                }
+                T await_resume() {
+                    return handle.promise().TakeResult();
+                }
+            };
+            return Awaiter {_handle};
+        }
+
+    private:
+        Handle _handle;
+    };
+
+    template<typename T>
+    Task<T> TaskPromise<T>::get_return_object() {
+        return Task<T>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+    }
+
+    inline Task<void> TaskPromise<void>::get_return_object() {
+        return Task<void>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+    }
+
+    // Runs eagerly and frees itself when done, used to start a Task from non-coroutine code
+    struct DetachedTask {
+        struct promise_type {
+            DetachedTask get_return_object() noexcept {
+                return {};
+            }
+            std::suspend_never initial_suspend() noexcept {
+                return {};
+            }
+            std::suspend_never final_suspend() noexcept {
+                return {};
+            }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept {
+                std::terminate();
+            }
+        };
+    };
+
+    /// Starts `task` on the calling thread and lets it run to completion on its own, e.g. an
+    /// asset load kicked off from the frame loop. An exception escaping it terminates.
+    inline void Spawn(Task<void> task) {
+        [](Task<void> spawned) -> DetachedTask { co_await std::move(spawned); }(std::move(task));
+    }
+
+    /// Starts `task` and blocks until it's done. For tools and tests, never call it from a
+    /// coroutine or from a thread the task needs to make progress (like a FrameExecutor's).
+    template<typename T>
+    T SyncWait(Task<T> task) {
+        std::promise<T> promise;
+        auto future = promise.get_future();
+        [](Task<T> waited, std::promise<T>& result) -> DetachedTask {
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    co_await std::move(waited);
+                    result.set_value();
+                } else {
+                    result.set_value(co_await std::move(waited));
+                }
+            } catch (...) { result.set_exception(std::current_exception()); }
+        }(std::move(task), promise);
+        return future.get();
+    }
+}  // namespace x
@@ -0,0 +1,128 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+#pragma once
+
+#include "Types.hpp"
+#include "Queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <optional>
+#include <type_traits>
+
+namespace x {
+    /// Chase-Lev work-stealing deque (the C11 formulation by Lê et al.). The owning thread pushes
+    /// and pops at the bottom without contention, any other thread steals from the top, so the
+    /// owner works depth-first on fresh jobs while thieves take the oldest, usually biggest ones.
+    /// Grows when full. Arrays outgrown by the owner are kept until the deque dies, since a thief
+    /// may still be reading one.
+    template<typename T>
+    class WorkStealingDeque {
+    public:
+        static_assert(std::is_trivially_copyable_v<T>, "Elements are read racily by thieves");
+
+        explicit WorkStealingDeque(const size_t capacity = 256) {
+            _arrays.push_back(make_unique<Array>(std::bit_ceil(std::max<size_t>(capacity, 2))));
+            _array.store(_arrays.back().get(), std::memory_order_relaxed);
+        }
+
+        WorkStealingDeque(const WorkStealingDeque&)            = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        /// Owner only.
+        void Push(const T value) {
+            const i64 bottom = _bottom.load(std::memory_order_relaxed);
+            const i64 top    = _top.load(std::memory_order_acquire);
+            Array* array     = _array.load(std::memory_order_relaxed);
+            if (bottom - top > CAST<i64>(array->capacity) - 1) { array = Grow(array, top, bottom); }
+            array->Put(bottom, value);
+            std::atomic_thread_fence(std::memory_order_release);
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        /// Owner only. Takes the most recently pushed element.
+        std::optional<T> Pop() {
+            const i64 bottom = _bottom.load(std::memory_order_relaxed) - 1;
+            Array* array     = _array.load(std::memory_order_relaxed);
+            _bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            i64 top = _top.load(std::memory_order_relaxed);
+
+            if (top > bottom) {
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+                return Empty;
+            }
+            const T value = array->Get(bottom);
+            if (top == bottom) {
+                // Last element, race the thieves for it
+                const bool won = _top.compare_exchange_strong(top,
+                                                              top + 1,
+                                                              std::memory_order_seq_cst,
+                                                              std::memory_order_relaxed);
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+                if (!won) { return Empty; }
+            }
+            return value;
+        }
+
+        /// Any thread. Takes the oldest element, returns Empty if the deque looked empty or
+        /// another thread won the race for it.
+        std::optional<T> Steal() {
+            i64 top = _top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const i64 bottom = _bottom.load(std::memory_order_acquire);
+            if (top >= bottom) { return Empty; }
+
+            const T value = _array.load(std::memory_order_acquire)->Get(top);
+            if (!_top.compare_exchange_strong(top,
+                                              top + 1,
+                                              std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+                return Empty;
+            }
+            return value;
+        }
+
+        [[nodiscard]] size_t SizeApprox() const {
+            const i64 size =
+              _bottom.load(std::memory_order_relaxed) - _top.load(std::memory_order_relaxed);
+            return size > 0 ? CAST<size_t>(size) : 0;
+        }
+
+    private:
+        struct Array {
+            explicit Array(const size_t size)
+                : capacity(size), mask(size - 1), values(make_unique<std::atomic<T>[]>(size)) {}
+
+            T Get(const i64 index) const {
+                return values[CAST<size_t>(index) & mask].load(std::memory_order_relaxed);
+            }
+
+            void Put(const i64 index, const T value) {
+                values[CAST<size_t>(index) & mask].store(value, std::memory_order_relaxed);
+            }
+
+            size_t capacity;
+            size_t mask;
+            unique_ptr<std::atomic<T>[]> values;
+        };
+
+        Array* Grow(const Array* array, const i64 top, const i64 bottom) {
+            auto grown = make_unique<Array>(array->capacity * 2);
+            for (i64 i = top; i < bottom; i++) {
+                grown->Put(i, array->Get(i));
+            }
+            _arrays.push_back(std::move(grown));
+            _array.store(_arrays.back().get(), std::memory_order_release);
+            return _arrays.back().get();
+        }
+
+        alignas(kCacheLineSize) std::atomic<i64> _top {0};
+        alignas(kCacheLineSize) std::atomic<i64> _bottom {0};
+        alignas(kCacheLineSize) std::atomic<Array*> _array;
+        vector<unique_ptr<Array>> _arrays;  // Owner only, every array ever used
+    };
+}  // namespace x
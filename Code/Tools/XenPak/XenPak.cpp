@@ -0,0 +1,52 @@
+// Author: Jake Rieger
+// Created: 10/16/26.
+//
+
+// Packs a directory tree into a .xpak archive.
+//
+// Usage: xen_pak [-c] <output.xpak> <root directory>
+//
+// Entries are named by their path relative to the root, with '/' separators, so packing the
+// build's bin directory gives entries like "Shaders/Unlit.vert.spv". With -c every file is
+// LZ4 compressed in independent chunks.
+
+#include "Archive.hpp"
+
+#include <cstdio>
+
+int main(int argc, char* argv[]) {
+    using namespace x;
+    using namespace x::Filesystem;
+
+    const bool compress = argc == 4 && str(argv[1]) == "-c";
+    if (argc != 3 && !compress) {
+        printf("Usage: %s [-c] <output.xpak> <root directory>\n", argv[0]);
+        return 1;
+    }
+    const char* output = argv[argc - 2];
+    const char* input  = argv[argc - 1];
+
+    const vector<PathId> files = Directory::Walk(input);
+    if (files.empty()) {
+        printf("Error: '%s' is not a directory or contains no files\n", input);
+        return 1;
+    }
+
+    // Walk() hands back normalized paths, strip the equally normalized root off the front
+    const std::string_view root = PathId(input).Str();
+    const size_t prefix         = root == "." ? 0 : root.size() + (root.ends_with('/') ? 0 : 1);
+
+    ArchiveBuilder builder;
+    for (const PathId file : files) {
+        const std::string_view path = file.Str();
+        builder.AddFile(str(path.substr(prefix)), str(path), compress);
+    }
+
+    if (!builder.Write(output)) {
+        printf("Error: failed to write '%s'\n", output);
+        return 1;
+    }
+
+    printf("Packed %zu files into '%s'\n", builder.GetEntryCount(), output);
+    return 0;
+}
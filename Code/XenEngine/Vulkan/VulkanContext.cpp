@@ -9,6 +9,7 @@
 #include "VulkanStruct.hpp"
 #include "Types.hpp"
 #include "Panic.inl"
+#include "Log.hpp"
 
 namespace x::vk {
     static const std::vector kValidationLayers = {"VK_LAYER_KHRONOS_validation"};
@@ -36,11 +37,11 @@ namespace x::vk {
         if (enableValidationLayers) {
             validationAvailable = CheckValidationLayerSupport();
             if (validationAvailable) {
-                printf("Validation layers are supported.\n");
+                LogInfo("Validation layers are supported.");
             } else {
-                printf("Note: Validation layers were requested but are not available. "
-                       "This is normal if you haven't installed vulkan-validationlayers. "
-                       "Continuing without validation.\n");
+                LogWarn("Validation layers were requested but are not available. "
+                        "This is normal if you haven't installed vulkan-validationlayers. "
+                        "Continuing without validation.");
             }
         }
 
@@ -71,7 +72,8 @@ namespace x::vk {
             Panic("Failed to create window surface.");
         }
 
-       _device = std::make_unique<VulkanDevice>(_instance, _surface);
+       // Device selection runs before any frame, its queries are released by the first BeginFrame()
+       _device = std::make_unique<VulkanDevice>(_instance, _surface, _frameArena.Current());
     }
 
     VulkanContext::~VulkanContext() {
@@ -91,4 +93,12 @@ namespace x::vk {
     VulkanDevice* VulkanContext::GetDevice() const {
         return _device.get();
     }
+
+    LinearArena& VulkanContext::BeginFrame(const u32 frameIndex) {
+        return _frameArena.BeginFrame(frameIndex);
+    }
+
+    LinearArena& VulkanContext::GetFrameScratch() {
+        return _frameArena.Current();
+    }
 }  // namespace x::vk
\ No newline at end of file
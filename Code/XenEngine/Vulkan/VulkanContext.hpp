@@ -8,6 +8,7 @@
 #include <GLFW/glfw3.h>
 #include <memory>
 
+#include "Arena.hpp"
 #include "VulkanDevice.hpp"
 
 namespace x::vk {
@@ -20,9 +21,18 @@ namespace x::vk {
         [[nodiscard]] VkSurfaceKHR GetSurface() const;
         [[nodiscard]] VulkanDevice* GetDevice() const;
 
+        /// Call once the fence of frame slot `frameIndex` has signaled. Releases the scratch
+        /// memory that slot used last time and returns the arena to record the frame with.
+        LinearArena& BeginFrame(u32 frameIndex);
+        /// Scratch memory of the frame being recorded.
+        [[nodiscard]] LinearArena& GetFrameScratch();
+
+        static constexpr u32 kMaxFramesInFlight = 2;
+
     private:
         VkInstance _instance = VK_NULL_HANDLE;
         VkSurfaceKHR _surface = VK_NULL_HANDLE;
+        FrameArena _frameArena {kMaxFramesInFlight};
         std::unique_ptr<VulkanDevice> _device;
     };
 }  // namespace x::vk
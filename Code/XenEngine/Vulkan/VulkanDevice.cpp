@@ -5,13 +5,14 @@
 #include "VulkanDevice.hpp"
 
 #include "VulkanStruct.hpp"
+#include "Log.hpp"
 
 #include <algorithm>
 #include <set>
 
 namespace x::vk {
-    VulkanDevice::VulkanDevice(VkInstance instance, VkSurfaceKHR surface) {
-        SelectPhysicalDevice(instance, surface);
+    VulkanDevice::VulkanDevice(VkInstance instance, VkSurfaceKHR surface, LinearArena& scratch) {
+        SelectPhysicalDevice(instance, surface, scratch);
         CreateLogicalDevice();
     }
 
@@ -19,7 +20,9 @@ namespace x::vk {
         if (_device != None) vkDestroyDevice(_device, None);
     }
 
-    void VulkanDevice::SelectPhysicalDevice(VkInstance instance, VkSurfaceKHR surface) {
+    void VulkanDevice::SelectPhysicalDevice(VkInstance instance,
+                                            VkSurfaceKHR surface,
+                                            LinearArena& scratch) {
         u32 deviceCount = 0;
         vkEnumeratePhysicalDevices(instance, &deviceCount, None);
 
@@ -27,12 +30,12 @@ namespace x::vk {
 
         std::vector<VkPhysicalDevice> devices(deviceCount);
         vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
-        const auto bestDevice = SelectBestDevice(devices, surface);
+        const auto bestDevice = SelectBestDevice(devices, surface, scratch);
         if (!bestDevice) { Panic("No suitable GPU found."); }
         _physicalDevice     = bestDevice;
-        _queueFamilyIndices = FindQueueFamilies(bestDevice, surface);
+        _queueFamilyIndices = FindQueueFamilies(bestDevice, surface, scratch);
 
-        printf("Found usable GPU\n");
+        LogInfo("Found usable GPU");
     }
 
     void VulkanDevice::CreateLogicalDevice() {
@@ -95,7 +98,9 @@ namespace x::vk {
         }
     };
 
-    i32 VulkanDevice::ScorePhysicalDevice(VkPhysicalDevice device, VkSurfaceKHR surface) {
+    i32 VulkanDevice::ScorePhysicalDevice(VkPhysicalDevice device,
+                                          VkSurfaceKHR surface,
+                                          LinearArena& scratch) {
         i32 score = 0;
 
         // Query device properties and features
@@ -122,7 +127,7 @@ namespace x::vk {
         }
 
         // Check queue families
-        QueueFamilyIndices indices = FindQueueFamilies(device, surface);
+        QueueFamilyIndices indices = FindQueueFamilies(device, surface, scratch);
         if (!indices.IsComplete()) {
             return 0;  // Device is unsuitable if it lacks required queue families
         }
@@ -174,29 +179,33 @@ namespace x::vk {
     }
 
     VkPhysicalDevice VulkanDevice::SelectBestDevice(const std::vector<VkPhysicalDevice>& devices,
-                                                    VkSurfaceKHR surface) {
+                                                    VkSurfaceKHR surface,
+                                                    LinearArena& scratch) {
         std::vector<DeviceScore> scoredDevices;
         scoredDevices.reserve(devices.size());
         for (const auto& device : devices) {
-            i32 score = ScorePhysicalDevice(device, surface);
+            i32 score = ScorePhysicalDevice(device, surface, scratch);
             if (score > 0) scoredDevices.emplace_back(device, score);
         }
         std::sort(scoredDevices.begin(), scoredDevices.end());
         return !scoredDevices.empty() ? scoredDevices[0].device : VK_NULL_HANDLE;
     }
 
-    bool VulkanDevice::IsDeviceSuitable(VkPhysicalDevice device, VkSurfaceKHR surface) {
-        return ScorePhysicalDevice(device, surface) > 0;
+    bool VulkanDevice::IsDeviceSuitable(VkPhysicalDevice device,
+                                        VkSurfaceKHR surface,
+                                        LinearArena& scratch) {
+        return ScorePhysicalDevice(device, surface, scratch) > 0;
     }
 
     QueueFamilyIndices VulkanDevice::FindQueueFamilies(VkPhysicalDevice device,
-                                                       VkSurfaceKHR surface) {
+                                                       VkSurfaceKHR surface,
+                                                       LinearArena& scratch) {
         QueueFamilyIndices indices;
 
         // Query queue family properties
         u32 queueFamilyCount = 0;
         vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, None);
-        std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+        ArenaVector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount, scratch);
         vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
 
         // Iterate through queue families to find ones supporting our required operations
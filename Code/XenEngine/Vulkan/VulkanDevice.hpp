@@ -8,6 +8,7 @@
 #include <vector>
 #include "Types.hpp"
 #include "Panic.inl"
+#include "Arena.hpp"
 
 namespace x::vk {
     struct QueueFamilyIndices {
@@ -23,7 +24,8 @@ namespace x::vk {
 
     class VulkanDevice {
     public:
-        VulkanDevice(VkInstance instance, VkSurfaceKHR surface);
+        /// `scratch` holds the temporary device queries, it can be reset once this returns.
+        VulkanDevice(VkInstance instance, VkSurfaceKHR surface, LinearArena& scratch);
         ~VulkanDevice();
 
         VulkanDevice(const VulkanDevice&)            = delete;
@@ -41,16 +43,20 @@ namespace x::vk {
         }
 
     private:
-        void SelectPhysicalDevice(VkInstance instance, VkSurfaceKHR surface);
+        void
+        SelectPhysicalDevice(VkInstance instance, VkSurfaceKHR surface, LinearArena& scratch);
         void CreateLogicalDevice();
 
-        [[nodiscard]] static bool IsDeviceSuitable(VkPhysicalDevice device, VkSurfaceKHR surface);
-        [[nodiscard]] static QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device,
-                                                                  VkSurfaceKHR surface);
+        [[nodiscard]] static bool
+        IsDeviceSuitable(VkPhysicalDevice device, VkSurfaceKHR surface, LinearArena& scratch);
+        [[nodiscard]] static QueueFamilyIndices
+        FindQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface, LinearArena& scratch);
         [[nodiscard]] static std::vector<const char*> GetRequiredDeviceExtensions();
-        [[nodiscard]] static i32 ScorePhysicalDevice(VkPhysicalDevice device, VkSurfaceKHR surface);
+        [[nodiscard]] static i32
+        ScorePhysicalDevice(VkPhysicalDevice device, VkSurfaceKHR surface, LinearArena& scratch);
         static VkPhysicalDevice SelectBestDevice(const std::vector<VkPhysicalDevice>& devices,
-                                                 VkSurfaceKHR surface);
+                                                 VkSurfaceKHR surface,
+                                                 LinearArena& scratch);
 
         VkPhysicalDevice _physicalDevice = VK_NULL_HANDLE;
         VkDevice _device                 = VK_NULL_HANDLE;
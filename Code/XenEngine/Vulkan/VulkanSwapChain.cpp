@@ -11,23 +11,24 @@ namespace x::vk {
     VulkanSwapChain::VulkanSwapChain(VulkanDevice* device,
                                      VkSurfaceKHR surface,
                                      u32 width,
-                                     u32 height)
+                                     u32 height,
+                                     LinearArena& scratch)
         : _device(device), _surface(surface) {
-        CreateSwapChain(width, height);
+        CreateSwapChain(width, height, scratch);
     }
 
     VulkanSwapChain::~VulkanSwapChain() {
         Cleanup();
     }
 
-    void VulkanSwapChain::Recreate(u32 width, u32 height) {
+    void VulkanSwapChain::Recreate(u32 width, u32 height, LinearArena& scratch) {
         Cleanup();
-        CreateSwapChain(width, height);
+        CreateSwapChain(width, height, scratch);
     }
 
-    void VulkanSwapChain::CreateSwapChain(u32 width, u32 height) {
+    void VulkanSwapChain::CreateSwapChain(u32 width, u32 height, LinearArena& scratch) {
         SwapChainSupportDetails swapSupport =
-          QuerySwapChainSupport(_device->GetPhysicalDevice(), _surface);
+          QuerySwapChainSupport(_device->GetPhysicalDevice(), _surface, scratch);
 
         VkSurfaceFormatKHR surfaceFormat = ChooseSwapSurfaceFormat(swapSupport.formats);
         VkPresentModeKHR presentMode     = ChooseSwapPresentMode(swapSupport.presentModes);
@@ -123,8 +124,9 @@ namespace x::vk {
     }
 
     SwapChainSupportDetails VulkanSwapChain::QuerySwapChainSupport(VkPhysicalDevice device,
-                                                                   VkSurfaceKHR surface) {
-        SwapChainSupportDetails details;
+                                                                   VkSurfaceKHR surface,
+                                                                   LinearArena& scratch) {
+        SwapChainSupportDetails details(scratch);
 
         vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, surface, &details.capabilities);
         u32 formatCount;
@@ -141,14 +143,17 @@ namespace x::vk {
         vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &presentModeCount, None);
         if (presentModeCount != 0) {
             details.presentModes.resize(presentModeCount);
-            vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &presentModeCount, None);
+            vkGetPhysicalDeviceSurfacePresentModesKHR(device,
+                                                      surface,
+                                                      &presentModeCount,
+                                                      details.presentModes.data());
         }
 
         return details;
     }
 
     VkSurfaceFormatKHR
-    VulkanSwapChain::ChooseSwapSurfaceFormat(const vector<VkSurfaceFormatKHR>& availableFormats) {
+    VulkanSwapChain::ChooseSwapSurfaceFormat(std::span<const VkSurfaceFormatKHR> availableFormats) {
         for (const auto& format : availableFormats) {
             if (format.format == VK_FORMAT_B8G8R8A8_SRGB &&
                 format.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
@@ -156,11 +161,11 @@ namespace x::vk {
             }
         }
 
-        return availableFormats.at(0);
+        return availableFormats.front();
     }
 
     VkPresentModeKHR
-    VulkanSwapChain::ChooseSwapPresentMode(const vector<VkPresentModeKHR>& availableModes) {
+    VulkanSwapChain::ChooseSwapPresentMode(std::span<const VkPresentModeKHR> availableModes) {
         for (const auto& mode : availableModes) {
             if (mode == VK_PRESENT_MODE_MAILBOX_KHR) { return mode; }
         }
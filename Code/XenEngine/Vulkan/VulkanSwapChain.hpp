@@ -6,18 +6,30 @@
 
 #include <vulkan/vulkan_core.h>
 #include "Types.hpp"
+#include "Arena.hpp"
 #include "VulkanDevice.hpp"
 
+#include <span>
+
 namespace x::vk {
+    /// Lives in the scratch arena it was queried with.
     struct SwapChainSupportDetails {
-        VkSurfaceCapabilitiesKHR capabilities;
-        vector<VkSurfaceFormatKHR> formats;
-        vector<VkPresentModeKHR> presentModes;
+        explicit SwapChainSupportDetails(LinearArena& scratch)
+            : formats(scratch), presentModes(scratch) {}
+
+        VkSurfaceCapabilitiesKHR capabilities {};
+        ArenaVector<VkSurfaceFormatKHR> formats;
+        ArenaVector<VkPresentModeKHR> presentModes;
     };
 
     class VulkanSwapChain {
     public:
-        VulkanSwapChain(VulkanDevice* device, VkSurfaceKHR surface, u32 width, u32 height);
+        /// `scratch` holds the temporary surface queries, usually the current frame's arena.
+        VulkanSwapChain(VulkanDevice* device,
+                        VkSurfaceKHR surface,
+                        u32 width,
+                        u32 height,
+                        LinearArena& scratch);
         ~VulkanSwapChain();
 
         // Prevent copying to avoid double-free of Vulkan resources
@@ -28,7 +40,7 @@ namespace x::vk {
         VulkanSwapChain(VulkanSwapChain&&) noexcept            = default;
         VulkanSwapChain& operator=(VulkanSwapChain&&) noexcept = default;
 
-        void Recreate(u32 width, u32 height);
+        void Recreate(u32 width, u32 height, LinearArena& scratch);
 
         [[nodiscard]] VkFormat GetImageFormat() const {
             return _imageFormat;
@@ -44,16 +56,16 @@ namespace x::vk {
         }
 
     private:
-        void CreateSwapChain(u32 width, u32 height);
+        void CreateSwapChain(u32 width, u32 height, LinearArena& scratch);
         void CreateImageViews();
         void Cleanup();
 
-        [[nodiscard]] static SwapChainSupportDetails QuerySwapChainSupport(VkPhysicalDevice device,
-                                                                           VkSurfaceKHR surface);
+        [[nodiscard]] static SwapChainSupportDetails
+        QuerySwapChainSupport(VkPhysicalDevice device, VkSurfaceKHR surface, LinearArena& scratch);
         [[nodiscard]] static VkSurfaceFormatKHR
-        ChooseSwapSurfaceFormat(const vector<VkSurfaceFormatKHR>& availableFormats);
+        ChooseSwapSurfaceFormat(std::span<const VkSurfaceFormatKHR> availableFormats);
         [[nodiscard]] static VkPresentModeKHR
-        ChooseSwapPresentMode(const vector<VkPresentModeKHR>& availableModes);
+        ChooseSwapPresentMode(std::span<const VkPresentModeKHR> availableModes);
         [[nodiscard]] static VkExtent2D
         ChooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities, u32 width, u32 height);
 
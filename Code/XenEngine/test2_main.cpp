@@ -76,7 +76,7 @@ int main() {
     using namespace x;
     using namespace x::vk;
 
-    auto createShaderModule = [](VkDevice device, const vector<u8>& bytecode) {
+    auto createShaderModule = [](VkDevice device, std::span<const u8> bytecode) {
         VulkanStruct<VkShaderModuleCreateInfo> createInfo;
         createInfo.codeSize = bytecode.size();
         createInfo.pCode    = RCAST<const u32*>(bytecode.data());
@@ -93,18 +93,24 @@ int main() {
     auto win     = window.GetWindow();
     auto context = std::make_unique<VulkanContext>(&win, true);
 
-    auto swapChain =
-      std::make_unique<VulkanSwapChain>(context->GetDevice(), context->GetSurface(), 800, 600);
+    auto swapChain = std::make_unique<VulkanSwapChain>(context->GetDevice(),
+                                                       context->GetSurface(),
+                                                       800,
+                                                       600,
+                                                       context->GetFrameScratch());
 
     auto builder = VulkanPipelineBuilder();
     vector<VkVertexInputBindingDescription> bindings;
     vector<VkVertexInputAttributeDescription> attributes;
     builder.SetVertexInput(bindings, attributes);
 
-    auto vertBytes  = Filesystem::FileReader::ReadAllBytes("Shaders/Unlit.vert.spv");
-    auto fragBytes  = Filesystem::FileReader::ReadAllBytes("Shaders/Unlit.frag.spv");
-    auto vertModule = createShaderModule(context->GetDevice()->GetLogicalDevice(), vertBytes);
-    auto fragModule = createShaderModule(context->GetDevice()->GetLogicalDevice(), fragBytes);
+    // Mappings are page aligned, so the SPIR-V can be handed to Vulkan without copying it
+    const Filesystem::MappedFile vertFile("Shaders/Unlit.vert.spv",
+                                          Filesystem::MappedFile::AccessHint::Sequential);
+    const Filesystem::MappedFile fragFile("Shaders/Unlit.frag.spv",
+                                          Filesystem::MappedFile::AccessHint::Sequential);
+    auto vertModule = createShaderModule(context->GetDevice()->GetLogicalDevice(), vertFile.Data());
+    auto fragModule = createShaderModule(context->GetDevice()->GetLogicalDevice(), fragFile.Data());
 
     builder.AddShaderStage(VK_SHADER_STAGE_VERTEX_BIT, vertModule)
       .AddShaderStage(VK_SHADER_STAGE_FRAGMENT_BIT, fragModule);
@@ -123,8 +129,30 @@ int main() {
 
     // auto pipeline = builder.Build(context->GetDevice());
 
+    // Re-running compile_shaders.py while this is open swaps in the new modules
+    Filesystem::FileWatcher shaderWatcher;
+    shaderWatcher.Watch("Shaders");
+    vector<Filesystem::FileChange> changes;
+
     while (!window.ShouldClose()) {
         window.PollEvents();
+
+        if (!shaderWatcher.Poll(changes)) { continue; }
+        for (const auto& change : changes) {
+            if (change.kind == Filesystem::FileChange::Kind::Removed) { continue; }
+
+            VkShaderModule* module = None;
+            if (change.path == "Shaders/Unlit.vert.spv") { module = &vertModule; }
+            if (change.path == "Shaders/Unlit.frag.spv") { module = &fragModule; }
+            if (!module) { continue; }
+
+            const Filesystem::MappedFile file(change.path,
+                                              Filesystem::MappedFile::AccessHint::Sequential);
+            if (file.Size() == 0) { continue; }
+            vkDestroyShaderModule(context->GetDevice()->GetLogicalDevice(), *module, None);
+            *module = createShaderModule(context->GetDevice()->GetLogicalDevice(), file.Data());
+        }
+        changes.clear();
     }
 
     vkDestroyPipelineLayout(context->GetDevice()->GetLogicalDevice(), objects.pipelineLayout, None);
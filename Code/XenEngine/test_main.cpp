@@ -10,10 +10,10 @@
 #include <glm/vec4.hpp>
 #include <glm/mat4x4.hpp>
 
-#include <iostream>
-
 #include "Types.hpp"
 #include "Panic.inl"
+#include "Log.hpp"
+#include "Arena.hpp"
 #include "Filesystem.hpp"
 #include "Window.hpp"
 #include "Vulkan/VulkanStruct.hpp"
@@ -24,6 +24,7 @@
 #include <set>
 #include <limits>
 #include <algorithm>
+#include <span>
 
 namespace x {
     using namespace Filesystem;
@@ -71,6 +72,11 @@ namespace x {
         VkSemaphore _renderFinished = VK_NULL_HANDLE;
         VkFence _inFlight           = VK_NULL_HANDLE;
 
+        // Scratch memory for the frame being recorded, one arena per frame in flight. The
+        // init-time device queries use it too and are released when the first frame begins.
+        static constexpr u32 kMaxFramesInFlight = 1;
+        mutable FrameArena _frameArena {kMaxFramesInFlight};
+
         struct QueueFamilyIndices {
             std::optional<u32> graphicsFamily;
             std::optional<u32> presentFamily;
@@ -86,8 +92,8 @@ namespace x {
 
         struct SwapChainSupportInfo {
             VkSurfaceCapabilitiesKHR capabilities;
-            std::vector<VkSurfaceFormatKHR> formats;
-            std::vector<VkPresentModeKHR> presentModes;
+            ArenaVector<VkSurfaceFormatKHR> formats;
+            ArenaVector<VkPresentModeKHR> presentModes;
         };
 
         void CreateSyncObjects() {
@@ -105,12 +111,13 @@ namespace x {
             if (vkCreateFence(_device, &fenceInfo, None, &_inFlight) != VK_SUCCESS) {
                 Panic("Failed to create 'in flight' fence.");
             }
-            printf("Created sync objects.\n");
+            LogInfo("Created sync objects.");
         }
 
         void DrawFrame() const {
             vkWaitForFences(_device, 1, &_inFlight, VK_TRUE, UINT64_MAX);
             vkResetFences(_device, 1, &_inFlight);
+            _frameArena.BeginFrame(0);
             u32 imageIndex;
             vkAcquireNextImageKHR(_device,
                                   _swapChain,
@@ -199,7 +206,7 @@ namespace x {
             if (vkAllocateCommandBuffers(_device, &allocInfo, &_commandBuffer) != VK_SUCCESS) {
                 Panic("Failed to allocate command buffers.");
             }
-            printf("Allocated (%d) command buffers.\n", 1U);
+            LogInfo("Allocated (%u) command buffers.", 1U);
         }
 
         void CreateCommandPool() {
@@ -210,7 +217,7 @@ namespace x {
             if (vkCreateCommandPool(_device, &poolInfo, None, &_commandPool) != VK_SUCCESS) {
                 Panic("Failed to create command pool.");
             }
-            printf("Created command pool.\n");
+            LogInfo("Created command pool.");
         }
 
         void CreateFramebuffers() {
@@ -226,10 +233,10 @@ namespace x {
                 framebufferInfo.layers          = 1;
                 if (vkCreateFramebuffer(_device, &framebufferInfo, None, &_frameBuffers[i]) !=
                     VK_SUCCESS) {
-                    Panic("Failed to create framebuffer for index %llu", i);
+                    Panic("Failed to create framebuffer for index %zu", i);
                 }
             }
-            printf("Created (%llu) framebuffers.\n", _frameBuffers.size());
+            LogInfo("Created (%zu) framebuffers.", _frameBuffers.size());
         }
 
         void CreateRenderPass() {
@@ -272,7 +279,7 @@ namespace x {
                 Panic("Failed to create render pass.");
             }
 
-            std::cout << "Created render pass.\n";
+            LogInfo("Created render pass.");
         }
 
         VkShaderModule CreateShaderModule(const std::vector<u8>& bytecode) const {
@@ -408,7 +415,7 @@ namespace x {
             vkDestroyShaderModule(_device, vertModule, None);
             vkDestroyShaderModule(_device, fragModule, None);
 
-            std::cout << "Created pipeline.\n";
+            LogInfo("Created pipeline.");
         }
 
         void CreateImageViews() {
@@ -433,7 +440,7 @@ namespace x {
                 }
             }
 
-            printf("Created (%llu) image views.\n", _swapChainImages.size());
+            LogInfo("Created (%zu) image views.", _swapChainImages.size());
         }
 
         void CreateSwapChain() {
@@ -484,7 +491,7 @@ namespace x {
             _swapChainFormat = surfaceFormat.format;
             _swapChainExtent = extent;
 
-            std::cout << "Created swap chain.\n";
+            LogInfo("Created swap chain.");
         }
 
         VkExtent2D ChooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities) const {
@@ -504,7 +511,7 @@ namespace x {
         }
 
         static VkPresentModeKHR
-        ChooseSwapChainMode(const std::vector<VkPresentModeKHR>& availableModes) {
+        ChooseSwapChainMode(std::span<const VkPresentModeKHR> availableModes) {
             for (const auto& mode : availableModes) {
                 if (mode == VK_PRESENT_MODE_MAILBOX_KHR) { return mode; }
             }
@@ -512,18 +519,21 @@ namespace x {
         }
 
         static VkSurfaceFormatKHR
-        ChooseSwapChainFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats) {
+        ChooseSwapChainFormat(std::span<const VkSurfaceFormatKHR> availableFormats) {
             for (const auto& info : availableFormats) {
                 if (info.format == VK_FORMAT_B8G8R8A8_SRGB &&
                     info.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
                     return info;
                 }
             }
-            return availableFormats.at(0);
+            return availableFormats.front();
         }
 
         SwapChainSupportInfo QuerySwapChainSupport(const VkPhysicalDevice device) const {
-            SwapChainSupportInfo info = {};
+            LinearArena& scratch      = _frameArena.Current();
+            SwapChainSupportInfo info = {{},
+                                         ArenaVector<VkSurfaceFormatKHR>(scratch),
+                                         ArenaVector<VkPresentModeKHR>(scratch)};
             vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, _surface, &info.capabilities);
 
             u32 fmtCount;
@@ -567,7 +577,7 @@ namespace x {
                 VK_SUCCESS) {
                 Panic("Failed to create window surface.");
             }
-            std::cout << "Created window surface.\n";
+            LogInfo("Created window surface.");
         }
 
         void CreateLogicalDevice() {
@@ -607,8 +617,7 @@ namespace x {
             vkGetDeviceQueue(_device, graphics, 0, &_graphicsQueue);
             vkGetDeviceQueue(_device, present, 0, &_presentQueue);
 
-            std::cout
-              << "Created logical device.\nCreated graphics queue.\nCreated presentation queue.\n";
+            LogInfo("Created logical device, graphics queue and presentation queue.");
         }
 
         QueueFamilyIndices FindQueueFamilies(const VkPhysicalDevice device) const {
@@ -616,7 +625,8 @@ namespace x {
 
             u32 queueFamilyCount = 0;
             vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, None);
-            std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+            ArenaVector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount,
+                                                               _frameArena.Current());
             vkGetPhysicalDeviceQueueFamilyProperties(device,
                                                      &queueFamilyCount,
                                                      queueFamilies.data());
@@ -695,7 +705,7 @@ namespace x {
         void CreateInstance() {
             if (_enableValidationLayers) {
                 if (CheckValidationLayerSupport()) {
-                    std::cout << "Validation layers enabled.\n";
+                    LogInfo("Validation layers enabled.");
                 } else {
                     Panic("Failed to enable validation layers for debug build.");
                 }
@@ -725,7 +735,7 @@ namespace x {
                 Panic("Failed to create Vulkan instance.");
             }
 
-            std::cout << "Created Vulkan instance.\n";
+            LogInfo("Created Vulkan instance.");
         }
 
         void InitWindow() {